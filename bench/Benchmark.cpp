@@ -0,0 +1,114 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Data.hpp"
+#include "Transaction.hpp"
+
+Benchmark::Benchmark(unsigned int iterations)
+    : iterations_(iterations ? iterations : 1)
+{}
+
+std::vector<Benchmark::Result> Benchmark::run(const Generator& generator) const
+{
+    std::vector<Result> results;
+    const Data::Environment& environment = generator.environment();
+    const std::vector<std::string>& configPaths = generator.configPaths();
+
+    // Loads everything once, which also warms up the page cache
+    Data data(environment, generator.PCIDevices(), generator.USBDevices());
+    const std::size_t numberOfConfigs = data.allPCIConfigs.size() + data.allUSBConfigs.size();
+
+    results.push_back({"Config::readConfigFile", configPaths.size(), measure([&]() {
+        for (const auto& configPath : configPaths)
+        {
+            const bool isUSB = (0 == configPath.compare(0, environment.USBConfigDir.size(),
+                    environment.USBConfigDir));
+            Config config(configPath, isUSB ? MHWD::BUS::USB : MHWD::BUS::PCI);
+            config.readConfigFile(configPath);
+        }
+    })});
+
+    results.push_back({"Data::fillAllConfigs", numberOfConfigs, measure([&]() {
+        data.allPCIConfigs.clear();
+        data.allUSBConfigs.clear();
+        data.invalidConfigs.clear();
+        data.fillAllConfigs(MHWD::BUS::PCI);
+        data.fillAllConfigs(MHWD::BUS::USB);
+    })});
+
+    results.push_back({"Data::setMatchingConfigs", numberOfConfigs, measure([&]() {
+        for (auto& device : data.PCIDevices)
+        {
+            device->availableConfigs_.clear();
+        }
+        for (auto& device : data.USBDevices)
+        {
+            device->availableConfigs_.clear();
+        }
+        data.setMatchingConfigs(data.PCIDevices, data.allPCIConfigs, false);
+        data.setMatchingConfigs(data.USBDevices, data.allUSBConfigs, false);
+    })});
+
+    std::vector<std::shared_ptr<Config>> allConfigs{data.allPCIConfigs};
+    allConfigs.insert(allConfigs.end(), data.allUSBConfigs.begin(), data.allUSBConfigs.end());
+
+    results.push_back({"Data::getAllDependenciesToInstall", allConfigs.size(), measure([&]() {
+        for (const auto& config : allConfigs)
+        {
+            data.getAllDependenciesToInstall(config);
+        }
+    })});
+
+    results.push_back({"Transaction::Transaction", allConfigs.size(), measure([&]() {
+        for (const auto& config : allConfigs)
+        {
+            Transaction transaction(data, config, MHWD::TRANSACTIONTYPE::INSTALL, false);
+        }
+    })});
+
+    return results;
+}
+
+double Benchmark::measure(const std::function<void()>& phase) const
+{
+    std::chrono::steady_clock::duration total{0};
+
+    for (unsigned int i = 0; i < iterations_; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        phase();
+        total += std::chrono::steady_clock::now() - start;
+    }
+
+    return std::chrono::duration<double, std::milli>(total).count() / iterations_;
+}
@@ -0,0 +1,59 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Generator.hpp"
+
+/*
+ * Times the hot paths of Data against a generated database. Declared a
+ * friend of Data to reach the loading and matching phases one by one.
+ */
+class Benchmark
+{
+public:
+    struct Result
+    {
+        std::string phase;
+        std::size_t items;
+        double milliseconds;
+    };
+
+    explicit Benchmark(unsigned int iterations);
+
+    std::vector<Result> run(const Generator& generator) const;
+
+private:
+    double measure(const std::function<void()>& phase) const;
+
+    unsigned int iterations_;
+};
+
+#endif /* BENCHMARK_HPP_ */
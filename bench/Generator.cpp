@@ -0,0 +1,298 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Generator.hpp"
+
+#include <ftw.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const std::vector<std::string> PCI_CLASSIDS {"0300", "0302", "0380", "0200", "0280", "0403",
+        "0c03", "0106", "0108", "0604", "0c05", "0780"};
+const std::vector<std::string> USB_CLASSIDS {"0e00", "e001", "0300", "0800", "0200", "0a00",
+        "0900", "ff00"};
+const std::vector<std::string> VENDORIDS {"10de", "1002", "8086", "14e4", "10ec", "168c",
+        "1969", "15ad", "80ee", "1b21", "8087", "046d", "0bda", "0cf3", "1af4"};
+const std::vector<std::string> CLASSNAMES {"Display controller", "Network controller",
+        "Multimedia controller", "Serial bus controller", "Mass storage controller", "Bridge"};
+
+constexpr unsigned int DEVICEID_POOL_SIZE = 256;
+
+void makeDirectory(const std::string& path)
+{
+    for (std::size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+    {
+        mkdir(path.substr(0, pos).c_str(), S_IRWXU);
+        if (std::string::npos == pos)
+        {
+            break;
+        }
+    }
+}
+
+void writeFile(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error{"failed to write '" + path + "'"};
+    }
+    file << content;
+}
+
+int removeEntry(const char* path, const struct stat*, int, struct FTW*)
+{
+    return remove(path);
+}
+
+}  // namespace
+
+Generator::Generator(unsigned int seed)
+    : random_(seed)
+{
+    char directory[] = "/tmp/mhwd-bench-XXXXXX";
+    if (nullptr == mkdtemp(directory))
+    {
+        throw std::runtime_error{"failed to create temporary directory"};
+    }
+    root_ = directory;
+
+    for (unsigned int i = 0; i < DEVICEID_POOL_SIZE; ++i)
+    {
+        deviceIDs_.push_back(randomHex(4));
+    }
+}
+
+Generator::~Generator()
+{
+    removeRoot();
+}
+
+void Generator::generate(unsigned int numberOfConfigs, unsigned int numberOfDevices)
+{
+    removeRoot();
+    configPaths_.clear();
+    configNames_.clear();
+    lastPCIConfig_.clear();
+    lastUSBConfig_.clear();
+    PCIDevices_.clear();
+    USBDevices_.clear();
+
+    environment_.PCIConfigDir = root_ + "/db/pci";
+    environment_.USBConfigDir = root_ + "/db/usb";
+    environment_.PCIDatabaseDir = root_ + "/local/pci";
+    environment_.USBDatabaseDir = root_ + "/local/usb";
+    for (const auto& dir : {environment_.PCIConfigDir, environment_.USBConfigDir,
+            environment_.PCIDatabaseDir, environment_.USBDatabaseDir})
+    {
+        makeDirectory(dir);
+    }
+
+    for (const auto& dir : {environment_.PCIConfigDir, environment_.USBConfigDir})
+    {
+        writeFile(dir + "/common.conf",
+                "# Shared settings pulled in with INCLUDE\n"
+                "INFO=\"Generated driver configuration\"\n"
+                "VERSION=\"2018.01.01\"\n");
+    }
+
+    for (unsigned int i = 0; i < numberOfConfigs; ++i)
+    {
+        writeConfig(i, (4 == i % 5) ? MHWD::BUS::USB : MHWD::BUS::PCI);
+    }
+
+    for (unsigned int i = 0; i < numberOfDevices; ++i)
+    {
+        if (4 == i % 5)
+        {
+            USBDevices_.push_back(makeDevice(MHWD::BUS::USB, i));
+        }
+        else
+        {
+            PCIDevices_.push_back(makeDevice(MHWD::BUS::PCI, i));
+        }
+    }
+}
+
+const Data::Environment& Generator::environment() const
+{
+    return environment_;
+}
+
+const std::vector<std::string>& Generator::configPaths() const
+{
+    return configPaths_;
+}
+
+const std::vector<std::shared_ptr<Device>>& Generator::PCIDevices() const
+{
+    return PCIDevices_;
+}
+
+const std::vector<std::shared_ptr<Device>>& Generator::USBDevices() const
+{
+    return USBDevices_;
+}
+
+void Generator::writeConfig(unsigned int index, MHWD::BUS type)
+{
+    const std::string name{"config-" + std::to_string(index)};
+    const std::vector<std::string>& classPool = (MHWD::BUS::USB == type) ? USB_CLASSIDS : PCI_CLASSIDS;
+    const std::string dbDir{(MHWD::BUS::USB == type) ? environment_.USBConfigDir : environment_.PCIConfigDir};
+    const std::string directory{dbDir + "/group-" + std::to_string(index % 16) + "/" + name};
+    makeDirectory(directory);
+
+    std::string content{"# mhwd Driver Config\n\n"};
+    if (chance(20))
+    {
+        content += "INCLUDE=\"../../common.conf\"\n";
+    }
+    content += "NAME=\"" + name + "\"\n";
+    content += "VERSION=\"2018." + std::to_string(index % 12 + 1) + ".01\"\n";
+    content += std::string("FREEDRIVER=\"") + (chance(50) ? "true" : "false") + "\"\n";
+    content += "PRIORITY=\"" + std::to_string(random_() % 10) + "\"\n\n";
+
+    const unsigned int groups = chance(10) ? 2 : 1;
+    for (unsigned int group = 0; group < groups; ++group)
+    {
+        content += "CLASSIDS=\"" + idList(classPool, 1 + random_() % 2) + "\"\n";
+        content += "VENDORIDS=\"" + (chance(10) ? std::string("*") : idList(VENDORIDS, 1 + random_() % 2)) + "\"\n";
+        if (chance(20))
+        {
+            content += "DEVICEIDS=\"*\"\n";
+        }
+        else if (chance(15))
+        {
+            writeFile(directory + "/device-ids", idList(deviceIDs_, 40) + "\n");
+            content += "DEVICEIDS=\">device-ids\"\n";
+        }
+        else
+        {
+            content += "DEVICEIDS=\"" + idList(deviceIDs_, 1 + random_() % 30) + "\"\n";
+        }
+        if (chance(10))
+        {
+            content += "BLACKLISTEDDEVICEIDS=\"" + idList(deviceIDs_, 1 + random_() % 4) + "\"\n";
+        }
+    }
+
+    // Chain dependencies to earlier configs of the same type
+    std::string& previous = (MHWD::BUS::USB == type) ? lastUSBConfig_ : lastPCIConfig_;
+    if (!previous.empty() && chance(60))
+    {
+        content += "\nMHWDDEPENDS=\"" + previous + "\"\n";
+    }
+    if (!configNames_.empty() && chance(10))
+    {
+        content += "MHWDCONFLICTS=\"" + configNames_[random_() % configNames_.size()] + "\"\n";
+    }
+    content += "DEPENDS=\"" + name + "-utils " + name + "-firmware\"\n";
+    content += "DEPENDS_64=\"lib32-" + name + "-utils\"\n\n";
+    content += "post_install()\n{\n    echo \"configured " + name + "\"\n}\n";
+
+    const std::string configPath{directory + "/" + MHWD_CONFIG_NAME};
+    writeFile(configPath, content);
+    configPaths_.push_back(configPath);
+    configNames_.push_back(name);
+    previous = name;
+
+    // Mark a few configs as installed
+    if (chance(5))
+    {
+        const std::string localDir{((MHWD::BUS::USB == type) ? environment_.USBDatabaseDir
+                : environment_.PCIDatabaseDir) + "/" + name};
+        makeDirectory(localDir);
+        writeFile(localDir + "/" + MHWD_CONFIG_NAME, content);
+    }
+}
+
+std::shared_ptr<Device> Generator::makeDevice(MHWD::BUS type, unsigned int index)
+{
+    std::shared_ptr<Device> device{new Device()};
+    device->type_ = type;
+    device->classID_ = pick((MHWD::BUS::USB == type) ? USB_CLASSIDS : PCI_CLASSIDS);
+    device->vendorID_ = pick(VENDORIDS);
+    device->deviceID_ = pick(deviceIDs_);
+    device->className_ = pick(CLASSNAMES);
+    device->vendorName_ = "Vendor " + device->vendorID_;
+    device->deviceName_ = "Device " + device->deviceID_;
+
+    char busID[32];
+    std::snprintf(busID, sizeof(busID), "0000:%02x:%02x.%x", index / 32, index % 32, index % 8);
+    device->sysfsBusID_ = busID;
+    device->sysfsID_ = "/devices/pci0000:00/" + device->sysfsBusID_;
+    return device;
+}
+
+std::string Generator::pick(const std::vector<std::string>& pool)
+{
+    return pool[random_() % pool.size()];
+}
+
+std::string Generator::randomHex(unsigned int digits)
+{
+    static const char hex[] = "0123456789abcdef";
+    std::string value;
+    for (unsigned int i = 0; i < digits; ++i)
+    {
+        value += hex[random_() % 16];
+    }
+    return value;
+}
+
+std::string Generator::idList(const std::vector<std::string>& pool, unsigned int count)
+{
+    std::string list;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!list.empty())
+        {
+            list += " ";
+        }
+        list += pick(pool);
+    }
+    return list;
+}
+
+bool Generator::chance(unsigned int percent)
+{
+    return (random_() % 100) < percent;
+}
+
+void Generator::removeRoot()
+{
+    nftw(root_.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
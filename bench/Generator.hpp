@@ -0,0 +1,76 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GENERATOR_HPP_
+#define GENERATOR_HPP_
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Data.hpp"
+#include "Device.hpp"
+
+/*
+ * Writes a synthetic config database below a temporary directory and makes
+ * up devices drawn from the same id pools, so that a realistic share of the
+ * configs match. Output is deterministic for a given seed.
+ */
+class Generator
+{
+public:
+    explicit Generator(unsigned int seed);
+    ~Generator();
+
+    void generate(unsigned int numberOfConfigs, unsigned int numberOfDevices);
+
+    const Data::Environment& environment() const;
+    const std::vector<std::string>& configPaths() const;
+    const std::vector<std::shared_ptr<Device>>& PCIDevices() const;
+    const std::vector<std::shared_ptr<Device>>& USBDevices() const;
+
+private:
+    void writeConfig(unsigned int index, MHWD::BUS type);
+    std::shared_ptr<Device> makeDevice(MHWD::BUS type, unsigned int index);
+    std::string pick(const std::vector<std::string>& pool);
+    std::string randomHex(unsigned int digits);
+    std::string idList(const std::vector<std::string>& pool, unsigned int count);
+    bool chance(unsigned int percent);
+    void removeRoot();
+
+    std::mt19937 random_;
+    std::string root_;
+    Data::Environment environment_;
+    std::vector<std::string> configPaths_;
+    std::vector<std::string> configNames_;
+    std::vector<std::string> deviceIDs_;
+    std::string lastPCIConfig_;
+    std::string lastUSBConfig_;
+    std::vector<std::shared_ptr<Device>> PCIDevices_;
+    std::vector<std::shared_ptr<Device>> USBDevices_;
+};
+
+#endif /* GENERATOR_HPP_ */
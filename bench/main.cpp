@@ -0,0 +1,142 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+#include "Generator.hpp"
+#include "vita/string.hpp"
+
+namespace
+{
+
+void printHelp()
+{
+    std::cout << "Usage: mhwd-bench [OPTIONS]\n\n"
+            << "  --configs <n[,n...]>\tnumber of generated configs per run (default 100,1000,5000)\n"
+            << "  --devices <n>\t\tnumber of generated devices (default 64)\n"
+            << "  --iterations <n>\trepetitions per phase (default 3)\n"
+            << "  --seed <n>\t\tseed of the generator (default 1)\n"
+            << "  -h/--help\t\tshow help\n" << std::endl;
+}
+
+unsigned int toNumber(const std::string& option, const std::string& value)
+{
+    char* end = nullptr;
+    const unsigned long number = std::strtoul(value.c_str(), &end, 10);
+    if (value.empty() || '\0' != *end)
+    {
+        throw std::runtime_error{"invalid value for " + option + ": " + value};
+    }
+    return static_cast<unsigned int>(number);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    std::vector<unsigned int> scales {100, 1000, 5000};
+    unsigned int numberOfDevices = 64;
+    unsigned int iterations = 3;
+    unsigned int seed = 1;
+
+    try
+    {
+        for (int nArg = 1; nArg < argc; ++nArg)
+        {
+            const std::string option{argv[nArg]};
+            if (("-h" == option) || ("--help" == option))
+            {
+                printHelp();
+                return 0;
+            }
+            else if (nArg + 1 >= argc)
+            {
+                throw std::runtime_error{"invalid option: " + option};
+            }
+            else if ("--configs" == option)
+            {
+                scales.clear();
+                for (const auto& scale : Vita::string(argv[++nArg]).explode(","))
+                {
+                    scales.push_back(toNumber(option, scale));
+                }
+            }
+            else if ("--devices" == option)
+            {
+                numberOfDevices = toNumber(option, argv[++nArg]);
+            }
+            else if ("--iterations" == option)
+            {
+                iterations = toNumber(option, argv[++nArg]);
+            }
+            else if ("--seed" == option)
+            {
+                seed = toNumber(option, argv[++nArg]);
+            }
+            else
+            {
+                throw std::runtime_error{"invalid option: " + option};
+            }
+        }
+
+        Generator generator(seed);
+        Benchmark benchmark(iterations);
+
+        std::cout << std::setw(8) << "CONFIGS"
+                << std::setw(9) << "DEVICES"
+                << std::setw(36) << "PHASE"
+                << std::setw(12) << "TOTAL ms"
+                << std::setw(14) << "PER ITEM us" << '\n';
+        std::cout << std::string(79, '-') << '\n';
+
+        for (const auto& scale : scales)
+        {
+            generator.generate(scale, numberOfDevices);
+            for (const auto& result : benchmark.run(generator))
+            {
+                std::cout << std::setw(8) << scale
+                        << std::setw(9) << numberOfDevices
+                        << std::setw(36) << result.phase
+                        << std::setw(12) << std::fixed << std::setprecision(3) << result.milliseconds
+                        << std::setw(14) << (result.items ? result.milliseconds * 1000.0 / result.items : 0.0)
+                        << std::endl;
+            }
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printHelp();
+        return 1;
+    }
+
+    return 0;
+}
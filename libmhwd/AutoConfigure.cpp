@@ -0,0 +1,131 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AutoConfigure.hpp"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+AutoConfigure::AutoConfigure(std::vector<MHWD::BUS> busTypes, std::vector<std::string> classIDs,
+        bool nonFreeDriver)
+    : busTypes_(busTypes), classIDs_(classIDs), nonFreeDriver_(nonFreeDriver)
+{}
+
+std::vector<AutoConfigure::Selection> AutoConfigure::select(const Data& data) const
+{
+    std::vector<Selection> selections;
+
+    for (const auto& busType : busTypes_)
+    {
+        const std::vector<std::shared_ptr<Config>>& installedConfigs =
+                (MHWD::BUS::USB == busType) ? data.installedUSBConfigs : data.installedPCIConfigs;
+
+        for (const auto& device : getDevices(data, busType))
+        {
+            if (!matchesAnyClassID(device->classID_))
+            {
+                continue;
+            }
+
+            Selection selection{device, nullptr, false};
+            for (const auto& availableConfig : device->availableConfigs_)
+            {
+                if (nonFreeDriver_ || availableConfig->freedriver_)
+                {
+                    selection.config = availableConfig;
+                    break;
+                }
+            }
+
+            if (nullptr != selection.config)
+            {
+                const std::string& name = selection.config->name_;
+                selection.installed = std::find_if(installedConfigs.begin(), installedConfigs.end(),
+                        [&name](const std::shared_ptr<Config>& config) {
+                            return config->name_ == name;
+                        }) != installedConfigs.end();
+            }
+            selections.push_back(selection);
+        }
+    }
+
+    return selections;
+}
+
+std::vector<std::string> AutoConfigure::unmatchedClassIDs(const Data& data) const
+{
+    std::vector<std::string> unmatched;
+
+    for (const auto& pattern : classIDs_)
+    {
+        bool found = false;
+        for (const auto& busType : busTypes_)
+        {
+            const auto& devices = getDevices(data, busType);
+            found = std::find_if(devices.begin(), devices.end(),
+                    [this, &pattern](const std::shared_ptr<Device>& device) {
+                        return matchesClassID(pattern, device->classID_);
+                    }) != devices.end();
+            if (found)
+            {
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            unmatched.push_back(pattern);
+        }
+    }
+
+    return unmatched;
+}
+
+const std::vector<std::shared_ptr<Device>>& AutoConfigure::getDevices(const Data& data,
+        MHWD::BUS busType) const
+{
+    if (MHWD::BUS::USB == busType)
+    {
+        return data.USBDevices;
+    }
+    return data.PCIDevices;
+}
+
+bool AutoConfigure::matchesClassID(const std::string& pattern, const std::string& classID) const
+{
+    return 0 == fnmatch(pattern.c_str(), classID.c_str(), 0);
+}
+
+bool AutoConfigure::matchesAnyClassID(const std::string& classID) const
+{
+    return std::find_if(classIDs_.begin(), classIDs_.end(),
+            [this, &classID](const std::string& pattern) {
+                return matchesClassID(pattern, classID);
+            }) != classIDs_.end();
+}
@@ -0,0 +1,69 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef AUTOCONFIGURE_HPP_
+#define AUTOCONFIGURE_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Data.hpp"
+#include "Device.hpp"
+#include "Enums.hpp"
+
+/*
+ * Picks the config -a/--auto would install for each device of the
+ * requested buses and classes. Class ids may be shell wildcards ("03*").
+ */
+class AutoConfigure
+{
+public:
+    struct Selection
+    {
+        std::shared_ptr<Device> device;
+        std::shared_ptr<Config> config;
+        bool installed;
+    };
+
+    AutoConfigure(std::vector<MHWD::BUS> busTypes, std::vector<std::string> classIDs,
+            bool nonFreeDriver);
+
+    std::vector<Selection> select(const Data& data) const;
+    std::vector<std::string> unmatchedClassIDs(const Data& data) const;
+
+private:
+    const std::vector<std::shared_ptr<Device>>& getDevices(const Data& data,
+            MHWD::BUS busType) const;
+    bool matchesClassID(const std::string& pattern, const std::string& classID) const;
+    bool matchesAnyClassID(const std::string& classID) const;
+
+    std::vector<MHWD::BUS> busTypes_;
+    std::vector<std::string> classIDs_;
+    bool nonFreeDriver_;
+};
+
+#endif /* AUTOCONFIGURE_HPP_ */
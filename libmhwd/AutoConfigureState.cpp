@@ -0,0 +1,212 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "AutoConfigureState.hpp"
+
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Profiler.hpp"
+#include "Utils.hpp"
+
+namespace
+{
+    const char* const SYSFS_BUS_DIR = "/sys/bus";
+}
+
+AutoConfigureState::AutoConfigureState(const Data::Environment& environment,
+        const std::string& request, const std::vector<MHWD::BUS>& busTypes,
+        const std::string& fixturePath)
+    : path_(environment.autoConfigureStatePath),
+      databaseDirs_{environment.PCIConfigDir, environment.USBConfigDir,
+            environment.PCIDatabaseDir, environment.USBDatabaseDir},
+      request_(request)
+{
+    Profiler::ScopedTimer timer("AutoConfigureState::AutoConfigureState");
+
+    database_ = readDatabase();
+
+    if (fixturePath.empty())
+    {
+        for (const auto& busType : busTypes)
+        {
+            addHardware(busType);
+        }
+    }
+    else
+    {
+        addFixture(fixturePath);
+    }
+
+    read();
+}
+
+bool AutoConfigureState::unchanged() const
+{
+    return sameDatabase_ && sameHardware_;
+}
+
+bool AutoConfigureState::knowsDevice(const Device& device) const
+{
+    return sameDatabase_ && (devices_.find(deviceKey(device)) != devices_.end());
+}
+
+bool AutoConfigureState::write(const std::vector<std::shared_ptr<Device>>& devices) const
+{
+    // Installing changed the local databases since they were read
+    const std::vector<std::string> database{readDatabase()};
+
+    std::ostringstream state;
+    state << "# mhwd auto-configure state, written after each successful -a/--auto\n";
+    state << "request|" << request_ << '\n';
+    for (const auto& line : database)
+    {
+        state << "database|" << line << '\n';
+    }
+    for (const auto& line : hardware_)
+    {
+        state << "hardware|" << line << '\n';
+    }
+    for (const auto& device : devices)
+    {
+        state << "device|" << deviceKey(*device) << '\n';
+    }
+
+    // A crash never leaves half a state behind
+    return MhwdUtils::writeFileAtomically(path_, state.str());
+}
+
+std::string AutoConfigureState::deviceKey(const Device& device)
+{
+    return MHWD::busName(device.type_) + ("|" + device.sysfsBusID_) + "|" + device.classID_ + "|"
+            + device.vendorID_ + "|" + device.deviceID_;
+}
+
+std::vector<std::string> AutoConfigureState::readDatabase() const
+{
+    std::vector<std::string> lines;
+    for (const auto& directory : databaseDirs_)
+    {
+        addDatabaseFiles(directory, lines);
+    }
+    return lines;
+}
+
+void AutoConfigureState::addDatabaseFiles(const std::string& directory,
+        std::vector<std::string>& lines) const
+{
+    for (const auto& name : MhwdUtils::listDirectory(directory))
+    {
+        const std::string path{directory + "/" + name};
+        struct stat fileStat;
+        if (0 != stat(path.c_str(), &fileStat))
+        {
+            continue;
+        }
+
+        if (S_ISDIR(fileStat.st_mode))
+        {
+            addDatabaseFiles(path, lines);
+        }
+        else
+        {
+            lines.push_back(path + "|" + std::to_string(fileStat.st_size) + "|"
+                    + std::to_string(static_cast<long long>(fileStat.st_mtime)));
+        }
+    }
+}
+
+void AutoConfigureState::addHardware(MHWD::BUS busType)
+{
+    // The modalias holds vendor, device and class ids; reading it needs no probing
+    const std::string bus{(MHWD::BUS::USB == busType) ? "usb" : "pci"};
+    const std::string devicesDir{std::string{SYSFS_BUS_DIR} + "/" + bus + "/devices"};
+
+    for (const auto& name : MhwdUtils::listDirectory(devicesDir))
+    {
+        std::ifstream file(devicesDir + "/" + name + "/modalias");
+        std::string modalias;
+        std::getline(file, modalias);
+        hardware_.push_back(bus + "|" + name + "|" + modalias);
+    }
+}
+
+void AutoConfigureState::addFixture(const std::string& fixturePath)
+{
+    std::ifstream file(fixturePath);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        hardware_.push_back("fixture|" + line);
+    }
+}
+
+void AutoConfigureState::read()
+{
+    std::ifstream file(path_);
+    if (!file)
+    {
+        return;
+    }
+
+    std::string request;
+    std::vector<std::string> database;
+    std::vector<std::string> hardware;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        const std::size_t pos = line.find('|');
+        if (std::string::npos == pos)
+        {
+            continue;
+        }
+
+        const std::string key{line.substr(0, pos)};
+        const std::string value{line.substr(pos + 1)};
+        if ("request" == key)
+        {
+            request = value;
+        }
+        else if ("database" == key)
+        {
+            database.push_back(value);
+        }
+        else if ("hardware" == key)
+        {
+            hardware.push_back(value);
+        }
+        else if ("device" == key)
+        {
+            devices_.insert(value);
+        }
+    }
+
+    sameDatabase_ = (request == request_) && (database == database_);
+    sameHardware_ = (hardware == hardware_);
+}
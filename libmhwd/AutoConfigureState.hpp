@@ -0,0 +1,75 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef AUTOCONFIGURESTATE_HPP_
+#define AUTOCONFIGURESTATE_HPP_
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Data.hpp"
+#include "Device.hpp"
+#include "Enums.hpp"
+
+/*
+ * What the last successful -a/--auto run saw: the request, the config
+ * databases (file names, sizes and mtimes) and the hardware (sysfs
+ * modaliases of the requested buses, or the fixture). Reading it back
+ * is cheap, so a run at boot can stop before probing and parsing when
+ * nothing changed, and otherwise only look at devices that are new.
+ */
+class AutoConfigureState
+{
+public:
+    AutoConfigureState(const Data::Environment& environment, const std::string& request,
+            const std::vector<MHWD::BUS>& busTypes, const std::string& fixturePath);
+
+    // Request, databases and hardware all match the last run
+    bool unchanged() const;
+    // The device was there last time, with the same request and databases
+    bool knowsDevice(const Device& device) const;
+    bool write(const std::vector<std::shared_ptr<Device>>& devices) const;
+
+private:
+    static std::string deviceKey(const Device& device);
+    std::vector<std::string> readDatabase() const;
+    void addDatabaseFiles(const std::string& directory, std::vector<std::string>& lines) const;
+    void addHardware(MHWD::BUS busType);
+    void addFixture(const std::string& fixturePath);
+    void read();
+
+    std::string path_;
+    std::vector<std::string> databaseDirs_;
+    std::string request_;
+    std::vector<std::string> database_;
+    std::vector<std::string> hardware_;
+    bool sameDatabase_ = false;
+    bool sameHardware_ = false;
+    std::unordered_set<std::string> devices_;
+};
+
+#endif /* AUTOCONFIGURESTATE_HPP_ */
@@ -23,13 +23,14 @@
  */
 
 #include "Config.hpp"
+#include "Profiler.hpp"
 #include "Utils.hpp"
 
 #include <fstream>
 #include <string>
 #include <vector>
 
-Config::Config(std::string configPath, std::string type)
+Config::Config(std::string configPath, MHWD::BUS type)
     : type_(type), basePath_(configPath.substr(0, configPath.find_last_of('/'))),
       configPath_(configPath), hwdIDs_(1)
 {}
@@ -42,11 +43,13 @@ bool Config::readConfigFile(std::string configPath)
     {
         return false;
     }
+    Profiler::instance().count(Profiler::COUNTER::FILES_READ);
 
     Vita::string line;
     Vita::string key;
     Vita::string value;
-    std::vector<Vita::string> parts;
+    // Views into line, reused for every line of the file
+    std::vector<Vita::stringview> parts;
 
     while (!file.eof())
     {
@@ -58,14 +61,17 @@ bool Config::readConfigFile(std::string configPath)
             line.erase(pos);
         }
 
-        if (line.trim().empty())
+        if (Vita::stringview(line).trim().empty())
         {
             continue;
         }
 
-        parts = line.explode("=");
-        key = parts.front().trim().toLower();
-        value = parts.back().trim("\"").trim();
+        line.split('=', parts);
+        const Vita::stringview keyView{parts.front().trim()};
+        const Vita::stringview valueView{parts.back().trim("\"").trim()};
+        key.assign(keyView.data(), keyView.size());
+        key.toLowerInPlace();
+        value.assign(valueView.data(), valueView.size());
 
         // Read in extern file
         if ((value.size() > 1) && (">" == value.substr(0, 1)))
@@ -75,6 +81,7 @@ bool Config::readConfigFile(std::string configPath)
             {
                 return false;
             }
+            Profiler::instance().count(Profiler::COUNTER::FILES_READ);
 
             Vita::string line;
             value.clear();
@@ -89,15 +96,17 @@ bool Config::readConfigFile(std::string configPath)
                     line.erase(pos);
                 }
 
-                if (line.trim().empty())
+                const Vita::stringview trimmed{Vita::stringview(line).trim()};
+                if (trimmed.empty())
                 {
                     continue;
                 }
 
-                value += " " + line.trim();
+                value += ' ';
+                value.append(trimmed.data(), trimmed.size());
             }
 
-            value = value.trim();
+            value.trimInPlace();
 
             // remove all multiple spaces
             while (value.find("  ") != std::string::npos)
@@ -106,13 +115,13 @@ bool Config::readConfigFile(std::string configPath)
             }
         }
 
-        switch(MhwdUtils::hash(std::string(key).c_str()))
+        switch(MhwdUtils::hash(key.c_str()))
         {
             case MhwdUtils::hash_compile_time("include"):
                 readConfigFile(getRightConfigPath(value, basePath_));
                 break;
             case MhwdUtils::hash_compile_time("name"):
-                name_ = value.toLower();
+                name_ = value.toLowerInPlace();
                 break;
             case MhwdUtils::hash_compile_time("version"):
                 version_ = value;
@@ -124,7 +133,7 @@ bool Config::readConfigFile(std::string configPath)
                 priority_ = value.convert<int>();
                 break;
             case MhwdUtils::hash_compile_time("freedriver"):
-                value = value.toLower();
+                value.toLowerInPlace();
                 freedriver_ = value == "false" ? false : true;
                 break;
             case MhwdUtils::hash_compile_time("classids"):
@@ -135,7 +144,7 @@ bool Config::readConfigFile(std::string configPath)
                     hwdIDs_.push_back(hwdID);
                 }
 
-                hwdIDs_.back().classIDs = splitValue(value);
+                hwdIDs_.back().classIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("vendorids"):
                 // Add new HardwareIDs group to vector if vector is not empty
@@ -145,7 +154,7 @@ bool Config::readConfigFile(std::string configPath)
                     hwdIDs_.push_back(hwdID);
                 }
 
-                hwdIDs_.back().vendorIDs = splitValue(value);
+                hwdIDs_.back().vendorIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("deviceids"):
                 // Add new HardwareIDs group to vector if vector is not empty
@@ -155,16 +164,16 @@ bool Config::readConfigFile(std::string configPath)
                     hwdIDs_.push_back(hwdID);
                 }
 
-                hwdIDs_.back().deviceIDs = splitValue(value);
+                hwdIDs_.back().deviceIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("blacklistedclassids"):
-                hwdIDs_.back().blacklistedClassIDs = splitValue(value);
+                hwdIDs_.back().blacklistedClassIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("blacklistedvendorids"):
-                hwdIDs_.back().blacklistedVendorIDs = splitValue(value);
+                hwdIDs_.back().blacklistedVendorIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("blacklisteddeviceids"):
-                hwdIDs_.back().blacklistedDeviceIDs = splitValue(value);
+                hwdIDs_.back().blacklistedDeviceIDs = splitIDs(value);
                 break;
             case MhwdUtils::hash_compile_time("mhwddepends"):
                 dependencies_ = splitValue(value);
@@ -172,6 +181,36 @@ bool Config::readConfigFile(std::string configPath)
             case MhwdUtils::hash_compile_time("mhwdconflicts"):
                 conflicts_ = splitValue(value);
                 break;
+            case MhwdUtils::hash_compile_time("depends"):
+                packages_.depends = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("depends_32"):
+                packages_.depends32 = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("depends_64"):
+                packages_.depends64 = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("conflicts"):
+                packages_.conflicts = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("conflicts_32"):
+                packages_.conflicts32 = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("conflicts_64"):
+                packages_.conflicts64 = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("confldd"):
+                packages_.conflictsNoDeps = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("confldd_64"):
+                packages_.conflictsNoDeps64 = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("depkmod"):
+                packages_.dependKernelModules = splitValue(value);
+                break;
+            case MhwdUtils::hash_compile_time("conkmod"):
+                packages_.conflictKernelModules = splitValue(value);
+                break;
         }
     }
 
@@ -200,26 +239,36 @@ bool Config::readConfigFile(std::string configPath)
 
 std::vector<std::string> Config::splitValue(Vita::string str, Vita::string onlyEnding)
 {
-    std::vector<Vita::string> work = str.toLower().explode(" ");
+    std::vector<Vita::stringview> work;
+    str.toLowerInPlace().split(' ', work);
     std::vector<std::string> final;
 
-    for (auto&& iterator = work.begin(); iterator != work.end();
-            ++iterator)
+    for (const auto& item : work)
     {
-        if (("" != *iterator) && onlyEnding.empty())
+        if (item.empty())
+        {
+            continue;
+        }
+
+        if (onlyEnding.empty())
         {
-            final.push_back(*iterator);
+            final.push_back(item.str());
         }
-        else if (("" != *iterator) && (Vita::string(*iterator).explode(".").back() == onlyEnding)
-                && ((*iterator).size() > 5))
+        else if ((item.substr(item.rfind('.') + 1) == onlyEnding) && (item.size() > 5))
         {
-            final.push_back(Vita::string(*iterator).substr(0, (*iterator).size() - 5));
+            final.push_back(item.substr(0, item.size() - 5).str());
         }
     }
 
     return final;
 }
 
+std::vector<InternedString> Config::splitIDs(Vita::string str)
+{
+    const std::vector<std::string> ids{splitValue(str)};
+    return std::vector<InternedString>(ids.begin(), ids.end());
+}
+
 Vita::string Config::getRightConfigPath(Vita::string str, Vita::string baseConfigPath)
 {
     str = str.trim();
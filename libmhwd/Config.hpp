@@ -29,24 +29,40 @@
 #include <vector>
 
 #include "Enums.hpp"
+#include "InternedString.hpp"
 #include "vita/string.hpp"
 
 struct Config
 {
-    Config(std::string configPath, std::string type);
+    Config(std::string configPath, MHWD::BUS type);
     bool readConfigFile(std::string configPath);
 
     struct HardwareID
     {
-        std::vector<std::string> classIDs;
-        std::vector<std::string> vendorIDs;
-        std::vector<std::string> deviceIDs;
-        std::vector<std::string> blacklistedClassIDs;
-        std::vector<std::string> blacklistedVendorIDs;
-        std::vector<std::string> blacklistedDeviceIDs;
+        std::vector<InternedString> classIDs;
+        std::vector<InternedString> vendorIDs;
+        std::vector<InternedString> deviceIDs;
+        std::vector<InternedString> blacklistedClassIDs;
+        std::vector<InternedString> blacklistedVendorIDs;
+        std::vector<InternedString> blacklistedDeviceIDs;
     };
 
-    std::string type_;
+    // Package lists the mhwd script works on, as declared in the config
+    struct Packages
+    {
+        std::vector<std::string> depends;
+        std::vector<std::string> depends32;
+        std::vector<std::string> depends64;
+        std::vector<std::string> conflicts;
+        std::vector<std::string> conflicts32;
+        std::vector<std::string> conflicts64;
+        std::vector<std::string> conflictsNoDeps;
+        std::vector<std::string> conflictsNoDeps64;
+        std::vector<std::string> dependKernelModules;
+        std::vector<std::string> conflictKernelModules;
+    };
+
+    MHWD::BUS type_;
     std::string basePath_;
     std::string configPath_;
     std::string name_;
@@ -57,9 +73,11 @@ struct Config
     std::vector<HardwareID> hwdIDs_;
     std::vector<std::string> conflicts_;
     std::vector<std::string> dependencies_;
+    Packages packages_;
 
 private:
     std::vector<std::string> splitValue(Vita::string str, Vita::string onlyEnding = "");
+    std::vector<InternedString> splitIDs(Vita::string str);
     Vita::string getRightConfigPath(Vita::string str, Vita::string baseConfigPath);
 };
 
@@ -28,19 +28,100 @@
 
 #include <algorithm>
 #include <fstream>
-#include <iomanip>
-#include <sstream>
+#include <functional>
+#include <future>
 #include <string>
 #include <vector>
 
+#include "HardwareDeviceSource.hpp"
+#include "Profiler.hpp"
+
+void Data::Environment::setRoot(const std::string& root)
+{
+    rootPath = root;
+    PMRootPath = root;
+    PMConfigPath = root + PMConfigPath;
+    PCIConfigDir = root + PCIConfigDir;
+    USBConfigDir = root + USBConfigDir;
+    PCIDatabaseDir = root + PCIDatabaseDir;
+    USBDatabaseDir = root + USBDatabaseDir;
+    scriptPath = root + scriptPath;
+    autoConfigureStatePath = root + autoConfigureStatePath;
+    metricsPath = root + metricsPath;
+}
+
 Data::Data()
+    : Data(Environment{}, HardwareDeviceSource{})
+{}
+
+Data::Data(const Environment& env, const DeviceSource& source)
+    : environment(env)
 {
-    fillDevices(hw_pci, PCIDevices);
-    fillDevices(hw_usb, USBDevices);
+    Profiler::ScopedTimer timer("Data::Data");
+
+    // Probing mostly waits on sysfs and the kernel while reading the database
+    // is parsing and file I/O: probe on other threads while this one reads
+    // the configs, and only wait for the devices when matching
+    std::future<void> PCIProbe;
+    std::future<void> USBProbe;
+    if (source.concurrentFill())
+    {
+        PCIProbe = std::async(std::launch::async, &Data::fillDevices, this,
+                std::cref(source), MHWD::BUS::PCI, std::ref(PCIDevices));
+        USBProbe = std::async(std::launch::async, &Data::fillDevices, this,
+                std::cref(source), MHWD::BUS::USB, std::ref(USBDevices));
+    }
+    else
+    {
+        PCIProbe = std::async(std::launch::async, [this, &source]() {
+            fillDevices(source, MHWD::BUS::PCI, PCIDevices);
+            fillDevices(source, MHWD::BUS::USB, USBDevices);
+        });
+    }
 
+    fillAllConfigs(MHWD::BUS::PCI);
+    fillAllConfigs(MHWD::BUS::USB);
+    fillInstalledConfigs(MHWD::BUS::PCI);
+    fillInstalledConfigs(MHWD::BUS::USB);
+
+    PCIProbe.get();
+    if (USBProbe.valid())
+    {
+        USBProbe.get();
+    }
+
+    setMatchingConfigs();
+}
+
+Data::Data(const Environment& env, std::vector<std::shared_ptr<Device>> PCIDeviceList,
+        std::vector<std::shared_ptr<Device>> USBDeviceList)
+    : environment(env), USBDevices(USBDeviceList), PCIDevices(PCIDeviceList)
+{
+    Profiler::ScopedTimer timer("Data::Data");
     updateConfigData();
 }
 
+Data::Data(const Data& other)
+    : environment(other.environment),
+      installedUSBConfigs(other.installedUSBConfigs),
+      installedPCIConfigs(other.installedPCIConfigs),
+      allUSBConfigs(other.allUSBConfigs),
+      allPCIConfigs(other.allPCIConfigs),
+      invalidConfigs(other.invalidConfigs),
+      version(other.version)
+{
+    // Devices carry their installed configs, so each copy needs its own.
+    // Configs are never changed once read and stay shared.
+    for (const auto& device : other.USBDevices)
+    {
+        USBDevices.push_back(std::make_shared<Device>(*device));
+    }
+    for (const auto& device : other.PCIDevices)
+    {
+        PCIDevices.push_back(std::make_shared<Device>(*device));
+    }
+}
+
 void Data::updateInstalledConfigData()
 {
     // Clear config vectors in each device element
@@ -59,31 +140,91 @@ void Data::updateInstalledConfigData()
     installedUSBConfigs.clear();
 
     // Refill data
-    fillInstalledConfigs("PCI");
-    fillInstalledConfigs("USB");
+    fillInstalledConfigs(MHWD::BUS::PCI);
+    fillInstalledConfigs(MHWD::BUS::USB);
 
     setMatchingConfigs(PCIDevices, installedPCIConfigs, true);
     setMatchingConfigs(USBDevices, installedUSBConfigs, true);
 }
 
-void Data::fillInstalledConfigs(std::string type)
+void Data::setDevices(const DeviceSource& source)
 {
+    PCIDevices.clear();
+    USBDevices.clear();
+    fillDevices(source, MHWD::BUS::PCI, PCIDevices);
+    fillDevices(source, MHWD::BUS::USB, USBDevices);
+
+    setMatchingConfigs();
+}
+
+void Data::addInstalledConfig(std::shared_ptr<Config> config)
+{
+    // Drop a previously installed version first, so reinstalls replace it
+    removeInstalledConfig(config);
+
+    if (MHWD::BUS::USB == config->type_)
+    {
+        installedUSBConfigs.push_back(config);
+        setMatchingConfig(config, USBDevices, true);
+    }
+    else
+    {
+        installedPCIConfigs.push_back(config);
+        setMatchingConfig(config, PCIDevices, true);
+    }
+}
+
+void Data::removeInstalledConfig(std::shared_ptr<Config> config)
+{
+    std::vector<std::shared_ptr<Config>>* installedConfigs;
+    std::vector<std::shared_ptr<Device>>* devices;
+
+    if (MHWD::BUS::USB == config->type_)
+    {
+        installedConfigs = &installedUSBConfigs;
+        devices = &USBDevices;
+    }
+    else
+    {
+        installedConfigs = &installedPCIConfigs;
+        devices = &PCIDevices;
+    }
+
+    const std::string name{config->name_};
+    auto sameName = [&name](const std::shared_ptr<Config>& installedConfig) {
+        return name == installedConfig->name_;
+    };
+
+    installedConfigs->erase(std::remove_if(installedConfigs->begin(), installedConfigs->end(),
+            sameName), installedConfigs->end());
+
+    for (auto& device : *devices)
+    {
+        device->installedConfigs_.erase(std::remove_if(device->installedConfigs_.begin(),
+                device->installedConfigs_.end(), sameName), device->installedConfigs_.end());
+    }
+}
+
+void Data::fillInstalledConfigs(MHWD::BUS type)
+{
+    Profiler::ScopedTimer timer(std::string{"Data::fillInstalledConfigs("} + MHWD::busName(type) + ")");
     std::vector<std::string> configPaths;
     std::vector<std::shared_ptr<Config>>* configs;
 
-    if ("USB" == type)
+    if (MHWD::BUS::USB == type)
     {
         configs = &installedUSBConfigs;
-        configPaths = getRecursiveDirectoryFileList(MHWD_USB_DATABASE_DIR, MHWD_CONFIG_NAME);
+        configPaths = getRecursiveDirectoryFileList(environment.USBDatabaseDir, MHWD_CONFIG_NAME);
     }
     else
     {
         configs = &installedPCIConfigs;
-        configPaths = getRecursiveDirectoryFileList(MHWD_PCI_DATABASE_DIR, MHWD_CONFIG_NAME);
+        configPaths = getRecursiveDirectoryFileList(environment.PCIDatabaseDir, MHWD_CONFIG_NAME);
     }
 
     for (const auto& configPath : configPaths)
     {
+        Profiler::instance().count(Profiler::COUNTER::CONFIGS_PARSED);
         Config *config = new Config(configPath, type);
 
         if (config->readConfigFile(configPath))
@@ -97,11 +238,11 @@ void Data::fillInstalledConfigs(std::string type)
     }
 }
 
-void Data::getAllDevicesOfConfig(std::shared_ptr<Config> config, std::vector<std::shared_ptr<Device>>& foundDevices)
+void Data::getAllDevicesOfConfig(std::shared_ptr<Config> config, std::vector<std::shared_ptr<Device>>& foundDevices) const
 {
     std::vector<std::shared_ptr<Device>> devices;
 
-    if ("USB" == config->type_)
+    if (MHWD::BUS::USB == config->type_)
     {
         devices = USBDevices;
     }
@@ -115,9 +256,12 @@ void Data::getAllDevicesOfConfig(std::shared_ptr<Config> config, std::vector<std
 
 void Data::getAllDevicesOfConfig(const std::vector<std::shared_ptr<Device>>& devices,
         std::shared_ptr<Config> config,
-        std::vector<std::shared_ptr<Device>>& foundDevices)
+        std::vector<std::shared_ptr<Device>>& foundDevices) const
 {
     foundDevices.clear();
+    unsigned long comparisons = 0;
+    // Ids are interned, so all of these compare pointers
+    static const InternedString wildcard{"*"};
 
     for (auto&& hwdID = config->hwdIDs_.begin();
             hwdID != config->hwdIDs_.end(); ++hwdID)
@@ -127,43 +271,45 @@ void Data::getAllDevicesOfConfig(const std::vector<std::shared_ptr<Device>>& dev
         for (auto&& i_device = devices.begin(); i_device != devices.end();
                 ++i_device)
         {
+            ++comparisons;
+
             // Check class ids
-            bool found = std::find_if(hwdID->classIDs.begin(), hwdID->classIDs.end(), [i_device](const std::string& classID){
-                                return (("*" == classID) || (classID == (*i_device)->classID_));
+            bool found = std::find_if(hwdID->classIDs.begin(), hwdID->classIDs.end(), [i_device](const InternedString& classID){
+                                return ((wildcard == classID) || (classID == (*i_device)->classID_));
                             }) != hwdID->classIDs.end();
 
             if (found)
             {
                 // Check blacklisted class ids
-                found = std::find_if(hwdID->blacklistedClassIDs.begin(), hwdID->blacklistedClassIDs.end(), [i_device](const std::string& blacklistedClassID){
+                found = std::find_if(hwdID->blacklistedClassIDs.begin(), hwdID->blacklistedClassIDs.end(), [i_device](const InternedString& blacklistedClassID){
                                 return (blacklistedClassID == (*i_device)->classID_);
                             }) != hwdID->blacklistedClassIDs.end();
 
                 if (!found)
                 {
                     // Check vendor ids
-                    found = std::find_if(hwdID->vendorIDs.begin(), hwdID->vendorIDs.end(), [i_device](const std::string& vendorID){
-                                    return (("*" == vendorID) || (vendorID == (*i_device)->vendorID_));
+                    found = std::find_if(hwdID->vendorIDs.begin(), hwdID->vendorIDs.end(), [i_device](const InternedString& vendorID){
+                                    return ((wildcard == vendorID) || (vendorID == (*i_device)->vendorID_));
                                 }) != hwdID->vendorIDs.end();
 
                     if (found)
                     {
                         // Check blacklisted vendor ids
-                        found = std::find_if(hwdID->blacklistedVendorIDs.begin(), hwdID->blacklistedVendorIDs.end(), [i_device](const std::string& blacklistedVendorID){
+                        found = std::find_if(hwdID->blacklistedVendorIDs.begin(), hwdID->blacklistedVendorIDs.end(), [i_device](const InternedString& blacklistedVendorID){
                                         return (blacklistedVendorID == (*i_device)->vendorID_);
                                     }) != hwdID->blacklistedVendorIDs.end();
 
                         if (!found)
                         {
                             // Check device ids
-                            found = std::find_if(hwdID->deviceIDs.begin(), hwdID->deviceIDs.end(), [i_device](const std::string& deviceID){
-                                            return (("*" == deviceID) || (deviceID == (*i_device)->deviceID_));
+                            found = std::find_if(hwdID->deviceIDs.begin(), hwdID->deviceIDs.end(), [i_device](const InternedString& deviceID){
+                                            return ((wildcard == deviceID) || (deviceID == (*i_device)->deviceID_));
                                         }) != hwdID->deviceIDs.end();
 
                             if (found)
                             {
                                 // Check blacklisted device ids
-                                found = std::find_if(hwdID->blacklistedDeviceIDs.begin(), hwdID->blacklistedDeviceIDs.end(), [i_device](const std::string& blacklistedDeviceID){
+                                found = std::find_if(hwdID->blacklistedDeviceIDs.begin(), hwdID->blacklistedDeviceIDs.end(), [i_device](const InternedString& blacklistedDeviceID){
                                                 return (blacklistedDeviceID == (*i_device)->deviceID_);
                                             }) != hwdID->blacklistedDeviceIDs.end();
                                 if (!found)
@@ -181,18 +327,20 @@ void Data::getAllDevicesOfConfig(const std::vector<std::shared_ptr<Device>>& dev
         if (!foundDevice)
         {
             foundDevices.clear();
-            return;
+            break;
         }
     }
+
+    Profiler::instance().count(Profiler::COUNTER::MATCH_COMPARISONS, comparisons);
 }
 
 std::vector<std::shared_ptr<Config>> Data::getAllDependenciesToInstall(
-        std::shared_ptr<Config> config)
+        std::shared_ptr<Config> config) const
 {
     std::vector<std::shared_ptr<Config>> depends;
     std::vector<std::shared_ptr<Config>> installedConfigs;
 
-    if ("USB" == config->type_)
+    if (MHWD::BUS::USB == config->type_)
     {
         installedConfigs = installedUSBConfigs;
     }
@@ -207,8 +355,8 @@ std::vector<std::shared_ptr<Config>> Data::getAllDependenciesToInstall(
 }
 
 void Data::getAllDependenciesToInstall(std::shared_ptr<Config> config,
-        std::vector<std::shared_ptr<Config>>& installedConfigs,
-        std::vector<std::shared_ptr<Config>> *dependencies)
+        const std::vector<std::shared_ptr<Config>>& installedConfigs,
+        std::vector<std::shared_ptr<Config>> *dependencies) const
 {
     for (const auto& configDependency : config->dependencies_)
     {
@@ -239,12 +387,77 @@ void Data::getAllDependenciesToInstall(std::shared_ptr<Config> config,
     }
 }
 
+std::shared_ptr<Config> Data::getInstalledConfig(const std::string& configName,
+        MHWD::BUS configType) const
+{
+    const std::vector<std::shared_ptr<Config>>* installedConfigs;
+
+    // Get the right configs
+    if (MHWD::BUS::USB == configType)
+    {
+        installedConfigs = &installedUSBConfigs;
+    }
+    else
+    {
+        installedConfigs = &installedPCIConfigs;
+    }
+
+    auto installedConfig = std::find_if(installedConfigs->begin(), installedConfigs->end(),
+            [configName](const std::shared_ptr<Config>& config) {
+                return configName == config->name_;
+            });
+
+    if (installedConfig != installedConfigs->end())
+    {
+        return *installedConfig;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Config> Data::getAvailableConfig(const std::string& configName,
+        MHWD::BUS configType) const
+{
+    const std::vector<std::shared_ptr<Device>> *devices;
+
+    // Get the right devices
+    if (MHWD::BUS::USB == configType)
+    {
+        devices = &USBDevices;
+    }
+    else
+    {
+        devices = &PCIDevices;
+    }
+
+    for (auto&& device = devices->begin(); device != devices->end();
+            ++device)
+    {
+        if ((*device)->availableConfigs_.empty())
+        {
+            continue;
+        }
+        else
+        {
+            auto& availableConfigs = (*device)->availableConfigs_;
+            auto availableConfig = std::find_if(availableConfigs.begin(), availableConfigs.end(),
+                    [configName](const std::shared_ptr<Config>& config){
+                        return config->name_ == configName;
+                    });
+            if (availableConfig != availableConfigs.end())
+            {
+                return *availableConfig;
+            }
+        }
+    }
+    return nullptr;
+}
+
 std::shared_ptr<Config> Data::getDatabaseConfig(const std::string configName,
-        const std::string configType)
+        MHWD::BUS configType) const
 {
     std::vector<std::shared_ptr<Config>> allConfigs;
 
-    if ("USB" == configType)
+    if (MHWD::BUS::USB == configType)
     {
         allConfigs = allUSBConfigs;
     }
@@ -266,13 +479,13 @@ std::shared_ptr<Config> Data::getDatabaseConfig(const std::string configName,
     return nullptr;
 }
 
-std::vector<std::shared_ptr<Config>> Data::getAllLocalConflicts(std::shared_ptr<Config> config)
+std::vector<std::shared_ptr<Config>> Data::getAllLocalConflicts(std::shared_ptr<Config> config) const
 {
     std::vector<std::shared_ptr<Config>> conflicts;
     std::vector<std::shared_ptr<Config>> dependencies = getAllDependenciesToInstall(config);
     std::vector<std::shared_ptr<Config>> installedConfigs;
 
-    if ("USB" == config->type_)
+    if (MHWD::BUS::USB == config->type_)
     {
         installedConfigs = installedUSBConfigs;
     }
@@ -310,12 +523,12 @@ std::vector<std::shared_ptr<Config>> Data::getAllLocalConflicts(std::shared_ptr<
     return conflicts;
 }
 
-std::vector<std::shared_ptr<Config>> Data::getAllLocalRequirements(std::shared_ptr<Config> config)
+std::vector<std::shared_ptr<Config>> Data::getAllLocalRequirements(std::shared_ptr<Config> config) const
 {
     std::vector<std::shared_ptr<Config>> requirements;
     std::vector<std::shared_ptr<Config>> installedConfigs;
 
-    if ("USB" == config->type_)
+    if (MHWD::BUS::USB == config->type_)
     {
         installedConfigs = installedUSBConfigs;
     }
@@ -349,51 +562,34 @@ std::vector<std::shared_ptr<Config>> Data::getAllLocalRequirements(std::shared_p
     return requirements;
 }
 
-void Data::fillDevices(hw_item hw, std::vector<std::shared_ptr<Device>>& devices)
+void Data::fillDevices(const DeviceSource& source, MHWD::BUS type,
+        std::vector<std::shared_ptr<Device>>& devices)
 {
-    // Get the hardware devices
-    std::unique_ptr<hd_data_t> hd_data{new hd_data_t()};
-    hd_t *hd = hd_list(hd_data.get(), hw, 1, nullptr);
-
-    std::unique_ptr<Device> device;
-    for (hd_t *hdIter = hd; hdIter; hdIter = hdIter->next)
-    {
-        device.reset(new Device());
-        device->type_ = (hw == hw_usb ? "USB" : "PCI");
-        device->classID_ = from_Hex(hdIter->base_class.id, 2) + from_Hex(hdIter->sub_class.id, 2).toLower();
-        device->vendorID_ = from_Hex(hdIter->vendor.id, 4).toLower();
-        device->deviceID_ = from_Hex(hdIter->device.id, 4).toLower();
-        device->className_ = from_CharArray(hdIter->base_class.name);
-        device->vendorName_ = from_CharArray(hdIter->vendor.name);
-        device->deviceName_ = from_CharArray(hdIter->device.name);
-        device->sysfsBusID_ = from_CharArray(hdIter->sysfs_bus_id);
-        device->sysfsID_ = from_CharArray(hdIter->sysfs_id);
-        devices.emplace_back(device.release());
-    }
-
-    hd_free_hd_list(hd);
-    hd_free_hd_data(hd_data.get());
+    Profiler::ScopedTimer timer(std::string{"Data::fillDevices("} + MHWD::busName(type) + ")");
+    source.fillDevices(type, devices);
 }
 
-void Data::fillAllConfigs(std::string type)
+void Data::fillAllConfigs(MHWD::BUS type)
 {
+    Profiler::ScopedTimer timer(std::string{"Data::fillAllConfigs("} + MHWD::busName(type) + ")");
     std::vector<std::string> configPaths;
     std::vector<std::shared_ptr<Config>>* configs;
 
-    if ("USB" == type)
+    if (MHWD::BUS::USB == type)
     {
         configs = &allUSBConfigs;
-        configPaths = getRecursiveDirectoryFileList(MHWD_USB_CONFIG_DIR, MHWD_CONFIG_NAME);
+        configPaths = getRecursiveDirectoryFileList(environment.USBConfigDir, MHWD_CONFIG_NAME);
     }
     else
     {
         configs = &allPCIConfigs;
-        configPaths = getRecursiveDirectoryFileList(MHWD_PCI_CONFIG_DIR, MHWD_CONFIG_NAME);
+        configPaths = getRecursiveDirectoryFileList(environment.PCIConfigDir, MHWD_CONFIG_NAME);
     }
 
     for (auto&& configPath = configPaths.begin();
             configPath != configPaths.end(); ++configPath)
     {
+        Profiler::instance().count(Profiler::COUNTER::CONFIGS_PARSED);
         std::unique_ptr<Config> config{new Config((*configPath), type)};
 
         if (config->readConfigFile((*configPath)))
@@ -474,8 +670,8 @@ void Data::updateConfigData()
     allPCIConfigs.clear();
     allUSBConfigs.clear();
 
-    fillAllConfigs("PCI");
-    fillAllConfigs("USB");
+    fillAllConfigs(MHWD::BUS::PCI);
+    fillAllConfigs(MHWD::BUS::USB);
 
     setMatchingConfigs(PCIDevices, allPCIConfigs, false);
     setMatchingConfigs(USBDevices, allUSBConfigs, false);
@@ -483,9 +679,19 @@ void Data::updateConfigData()
     updateInstalledConfigData();
 }
 
+void Data::setMatchingConfigs()
+{
+    setMatchingConfigs(PCIDevices, allPCIConfigs, false);
+    setMatchingConfigs(USBDevices, allUSBConfigs, false);
+    setMatchingConfigs(PCIDevices, installedPCIConfigs, true);
+    setMatchingConfigs(USBDevices, installedUSBConfigs, true);
+}
+
 void Data::setMatchingConfigs(const std::vector<std::shared_ptr<Device>>& devices,
         std::vector<std::shared_ptr<Config>>& configs, bool setAsInstalled)
 {
+    Profiler::ScopedTimer timer("Data::setMatchingConfigs");
+
     for (auto& config : configs)
     {
         setMatchingConfig(config, devices, setAsInstalled);
@@ -535,20 +741,3 @@ void Data::addConfigSorted(std::vector<std::shared_ptr<Config>>& configs,
         configs.emplace_back(newConfig);
     }
 }
-
-Vita::string Data::from_Hex(std::uint16_t hexnum, int fill)
-{
-    std::stringstream stream;
-    stream << std::hex << std::setfill('0') << std::setw(fill) << hexnum;
-    return stream.str();
-}
-
-std::string Data::from_CharArray(char* c)
-{
-    if (nullptr == c)
-    {
-        return "";
-    }
-
-    return std::string(c);
-}
@@ -25,7 +25,6 @@
 #ifndef DATA_HPP_
 #define DATA_HPP_
 
-#include <hd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -36,22 +35,42 @@
 #include "Config.hpp"
 #include "const.h"
 #include "Device.hpp"
+#include "DeviceSource.hpp"
+#include "Enums.hpp"
 #include "vita/string.hpp"
 
 class Data
 {
 public:
-    Data();
-    ~Data() = default;
-
     struct Environment
     {
             std::string PMCachePath {MHWD_PM_CACHE_DIR};
             std::string PMConfigPath {MHWD_PM_CONFIG};
             std::string PMRootPath {MHWD_PM_ROOT};
+            // The system configs are applied to, the script runs their hooks chrooted into it
+            std::string rootPath {"/"};
+            std::string PCIConfigDir {MHWD_PCI_CONFIG_DIR};
+            std::string USBConfigDir {MHWD_USB_CONFIG_DIR};
+            std::string PCIDatabaseDir {MHWD_PCI_DATABASE_DIR};
+            std::string USBDatabaseDir {MHWD_USB_DATABASE_DIR};
+            std::string scriptPath {MHWD_SCRIPT_PATH};
+            std::string autoConfigureStatePath {MHWD_AUTOCONFIGURE_STATE};
+            std::string metricsPath {MHWD_METRICS_STORE};
             bool syncPackageManagerDatabase = true;
+
+            // Move every path below root, except the shared package cache
+            void setRoot(const std::string& root);
     };
 
+    Data();
+    Data(const Environment& env, const DeviceSource& source);
+    Data(const Environment& env, std::vector<std::shared_ptr<Device>> PCIDeviceList,
+            std::vector<std::shared_ptr<Device>> USBDeviceList);
+    Data(const Data& other);
+    // Only copied whole, by DataStore; an assignment would share the other's devices
+    Data& operator=(const Data&) = delete;
+    ~Data() = default;
+
     Environment environment;
     std::vector<std::shared_ptr<Device>> USBDevices;
     std::vector<std::shared_ptr<Device>> PCIDevices;
@@ -60,25 +79,41 @@ public:
     std::vector<std::shared_ptr<Config>> allUSBConfigs;
     std::vector<std::shared_ptr<Config>> allPCIConfigs;
     std::vector<std::shared_ptr<Config>> invalidConfigs;
+    // Raised by DataStore for every snapshot it publishes
+    unsigned long version = 0;
 
     void updateInstalledConfigData();
-    void getAllDevicesOfConfig(std::shared_ptr<Config> config, std::vector<std::shared_ptr<Device>>& foundDevices);
+    // Replaces the devices and matches them against the configs already read
+    void setDevices(const DeviceSource& source);
+    void addInstalledConfig(std::shared_ptr<Config> config);
+    void removeInstalledConfig(std::shared_ptr<Config> config);
+    void getAllDevicesOfConfig(std::shared_ptr<Config> config,
+            std::vector<std::shared_ptr<Device>>& foundDevices) const;
 
-    std::vector<std::shared_ptr<Config>> getAllDependenciesToInstall(std::shared_ptr<Config> config);
+    std::vector<std::shared_ptr<Config>> getAllDependenciesToInstall(std::shared_ptr<Config> config) const;
     void getAllDependenciesToInstall(std::shared_ptr<Config> config,
-            std::vector<std::shared_ptr<Config>>& installedConfigs,
-            std::vector<std::shared_ptr<Config>> *depends);
+            const std::vector<std::shared_ptr<Config>>& installedConfigs,
+            std::vector<std::shared_ptr<Config>> *depends) const;
     std::shared_ptr<Config> getDatabaseConfig(const std::string configName,
-            const std::string configType);
-    std::vector<std::shared_ptr<Config>> getAllLocalConflicts(std::shared_ptr<Config> config);
-    std::vector<std::shared_ptr<Config>> getAllLocalRequirements(std::shared_ptr<Config> config);
+            MHWD::BUS configType) const;
+    std::shared_ptr<Config> getInstalledConfig(const std::string& configName,
+            MHWD::BUS configType) const;
+    std::shared_ptr<Config> getAvailableConfig(const std::string& configName,
+            MHWD::BUS configType) const;
+    std::vector<std::shared_ptr<Config>> getAllLocalConflicts(std::shared_ptr<Config> config) const;
+    std::vector<std::shared_ptr<Config>> getAllLocalRequirements(std::shared_ptr<Config> config) const;
 
 private:
+    friend class Benchmark;
+
     void getAllDevicesOfConfig(const std::vector<std::shared_ptr<Device>>& devices,
-            std::shared_ptr<Config> config, std::vector<std::shared_ptr<Device>>& foundDevices);
-    void fillInstalledConfigs(std::string type);
-    void fillDevices(hw_item hw, std::vector<std::shared_ptr<Device>>& devices);
-    void fillAllConfigs(std::string type);
+            std::shared_ptr<Config> config, std::vector<std::shared_ptr<Device>>& foundDevices) const;
+    void fillInstalledConfigs(MHWD::BUS type);
+    void fillDevices(const DeviceSource& source, MHWD::BUS type,
+            std::vector<std::shared_ptr<Device>>& devices);
+    void fillAllConfigs(MHWD::BUS type);
+    // Matches all devices against all configs, available and installed
+    void setMatchingConfigs();
     void setMatchingConfigs(const std::vector<std::shared_ptr<Device>>& devices,
             std::vector<std::shared_ptr<Config>>& configs, bool setAsInstalled);
     void setMatchingConfig(std::shared_ptr<Config> config, const std::vector<std::shared_ptr<Device>>& devices,
@@ -89,9 +124,6 @@ private:
 
     Vita::string getRightConfigPath(Vita::string str, Vita::string baseConfigPath);
     void updateConfigData();
-
-    Vita::string from_Hex(uint16_t hexnum, int fill);
-    std::string from_CharArray(char* c);
 };
 
 #endif /* DATA_HPP_ */
@@ -0,0 +1,51 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DataStore.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+DataStore::DataStore(std::unique_ptr<Data> data)
+    : data_(std::move(data))
+{}
+
+std::shared_ptr<const Data> DataStore::snapshot() const
+{
+    return std::atomic_load(&data_);
+}
+
+void DataStore::update(const std::function<void(Data&)>& change)
+{
+    // Writers queue up, readers carry on with the current snapshot
+    std::lock_guard<std::mutex> lock(writeMutex_);
+
+    std::shared_ptr<Data> next{new Data(*std::atomic_load(&data_))};
+    change(*next);
+    ++next->version;
+    std::atomic_store(&data_, std::shared_ptr<const Data>{next});
+}
@@ -0,0 +1,54 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DATASTORE_HPP_
+#define DATASTORE_HPP_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "Data.hpp"
+
+/*
+ * Holds the current Data as an immutable snapshot. Readers take a
+ * snapshot and keep using it for as long as they hold it, without
+ * locking; writers change a copy and publish it as the next version.
+ * A published Data is never modified again.
+ */
+class DataStore
+{
+public:
+    explicit DataStore(std::unique_ptr<Data> data);
+
+    std::shared_ptr<const Data> snapshot() const;
+    void update(const std::function<void(Data&)>& change);
+
+private:
+    std::shared_ptr<const Data> data_;
+    std::mutex writeMutex_;
+};
+
+#endif /* DATASTORE_HPP_ */
@@ -30,16 +30,18 @@
 #include <vector>
 
 #include "Config.hpp"
+#include "Enums.hpp"
+#include "InternedString.hpp"
 
 struct Device
 {
-    std::string type_;
-    std::string className_;
-    std::string deviceName_;
-    std::string vendorName_;
-    std::string classID_;
-    std::string deviceID_;
-    std::string vendorID_;
+    MHWD::BUS type_ = MHWD::BUS::PCI;
+    InternedString className_;
+    InternedString deviceName_;
+    InternedString vendorName_;
+    InternedString classID_;
+    InternedString deviceID_;
+    InternedString vendorID_;
     std::string sysfsBusID_;
     std::string sysfsID_;
     std::vector<std::shared_ptr<Config>> availableConfigs_;
@@ -1,6 +1,6 @@
 /*
  *  This file is part of the mhwd - Manjaro Hardware Detection project
- *  
+ *
  *  mhwd - Manjaro Hardware Detection
  *  Roland Singer <roland@manjaro.org>
  *  Łukasz Matysiak <december0123@gmail.com>
@@ -22,40 +22,28 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef ENUMS_HPP_
-#define ENUMS_HPP_
 
-namespace MHWD
-{
+#ifndef DEVICESOURCE_HPP_
+#define DEVICESOURCE_HPP_
 
-enum class STATUS
-{
-    SUCCESS,
-    ERROR_CONFLICTS,
-    ERROR_REQUIREMENTS,
-    ERROR_NOT_INSTALLED,
-    ERROR_ALREADY_INSTALLED,
-    ERROR_NO_MATCH_LOCAL_CONFIG,
-    ERROR_SCRIPT_FAILED,
-    ERROR_SET_DATABASE
-};
+#include <memory>
+#include <string>
+#include <vector>
 
-enum class MESSAGETYPE
-{
-    CONSOLE_OUTPUT,
-    INSTALLDEPENDENCY_START,
-    INSTALLDEPENDENCY_END,
-    INSTALL_START,
-    INSTALL_END,
-    REMOVE_START,
-    REMOVE_END
-};
+#include "Device.hpp"
 
-enum class TRANSACTIONTYPE
+/*
+ * Where Data gets its devices from: the live system or a recorded fixture.
+ */
+class DeviceSource
 {
-    INSTALL, REMOVE
-};
+public:
+    virtual ~DeviceSource() = default;
 
-}  // namespace MHWD
+    virtual void fillDevices(MHWD::BUS type,
+            std::vector<std::shared_ptr<Device>>& devices) const = 0;
+    // False if fillDevices must not run for both buses at the same time
+    virtual bool concurrentFill() const { return true; }
+};
 
-#endif /* ENUMS_HPP_ */
+#endif /* DEVICESOURCE_HPP_ */
@@ -0,0 +1,143 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *  
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENUMS_HPP_
+#define ENUMS_HPP_
+
+#include <cctype>
+#include <string>
+
+namespace MHWD
+{
+
+enum class STATUS
+{
+    SUCCESS,
+    ERROR_CONFLICTS,
+    ERROR_REQUIREMENTS,
+    ERROR_NOT_INSTALLED,
+    ERROR_ALREADY_INSTALLED,
+    ERROR_NO_MATCH_LOCAL_CONFIG,
+    ERROR_SCRIPT_FAILED,
+    ERROR_SET_DATABASE
+};
+
+enum class MESSAGETYPE
+{
+    CONSOLE_OUTPUT,
+    INSTALLDEPENDENCY_START,
+    INSTALLDEPENDENCY_END,
+    INSTALL_START,
+    INSTALL_END,
+    REMOVE_START,
+    REMOVE_END
+};
+
+enum class TRANSACTIONTYPE
+{
+    INSTALL, REMOVE
+};
+
+enum class BUS
+{
+    PCI, USB
+};
+
+// "PCI" or "USB", as written in plans, fixtures and output
+inline const char* busName(BUS bus)
+{
+    return (BUS::USB == bus) ? "USB" : "PCI";
+}
+
+// As written in JSON output and progress events
+inline const char* messageTypeName(MESSAGETYPE type)
+{
+    switch (type)
+    {
+        case MESSAGETYPE::CONSOLE_OUTPUT:
+            return "output";
+        case MESSAGETYPE::INSTALLDEPENDENCY_START:
+            return "install_dependency_start";
+        case MESSAGETYPE::INSTALLDEPENDENCY_END:
+            return "install_dependency_end";
+        case MESSAGETYPE::INSTALL_START:
+            return "install_start";
+        case MESSAGETYPE::INSTALL_END:
+            return "install_end";
+        case MESSAGETYPE::REMOVE_START:
+            return "remove_start";
+        case MESSAGETYPE::REMOVE_END:
+            return "remove_end";
+    }
+    return "unknown";
+}
+
+inline const char* statusName(STATUS status)
+{
+    switch (status)
+    {
+        case STATUS::SUCCESS:
+            return "success";
+        case STATUS::ERROR_CONFLICTS:
+            return "error_conflicts";
+        case STATUS::ERROR_REQUIREMENTS:
+            return "error_requirements";
+        case STATUS::ERROR_NOT_INSTALLED:
+            return "error_not_installed";
+        case STATUS::ERROR_ALREADY_INSTALLED:
+            return "error_already_installed";
+        case STATUS::ERROR_NO_MATCH_LOCAL_CONFIG:
+            return "error_no_match_local_config";
+        case STATUS::ERROR_SCRIPT_FAILED:
+            return "error_script_failed";
+        case STATUS::ERROR_SET_DATABASE:
+            return "error_set_database";
+    }
+    return "unknown";
+}
+
+// Accepts "PCI" and "USB" in any case
+inline bool parseBus(std::string name, BUS& bus)
+{
+    for (auto& c : name)
+    {
+        c = std::tolower(static_cast<unsigned char>(c));
+    }
+
+    if ("pci" == name)
+    {
+        bus = BUS::PCI;
+        return true;
+    }
+    if ("usb" == name)
+    {
+        bus = BUS::USB;
+        return true;
+    }
+    return false;
+}
+
+}  // namespace MHWD
+
+#endif /* ENUMS_HPP_ */
@@ -0,0 +1,106 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "FixtureDeviceSource.hpp"
+
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vita/string.hpp"
+
+FixtureDeviceSource::FixtureDeviceSource(const std::string& fixturePath)
+{
+    std::ifstream file(fixturePath);
+    if (!file)
+    {
+        throw std::runtime_error{"failed to read fixture '" + fixturePath + "'"};
+    }
+
+    Vita::string line;
+    std::vector<Vita::stringview> fields;
+    unsigned int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        line.trimInPlace();
+        if (line.empty() || ('#' == line[0]))
+        {
+            continue;
+        }
+
+        line.split('|', fields);
+        fields.resize(9);
+        for (auto& field : fields)
+        {
+            field = field.trim();
+        }
+
+        MHWD::BUS type;
+        if (!MHWD::parseBus(fields[0].str(), type) || fields[1].empty())
+        {
+            throw std::runtime_error{"invalid device in fixture '" + fixturePath + "' line "
+                    + std::to_string(lineNumber)};
+        }
+
+        std::shared_ptr<Device> device{new Device()};
+        device->type_ = type;
+        device->classID_ = Vita::string(fields[1].str()).toLowerInPlace();
+        device->vendorID_ = Vita::string(fields[2].str()).toLowerInPlace();
+        device->deviceID_ = Vita::string(fields[3].str()).toLowerInPlace();
+        device->sysfsBusID_ = fields[4].str();
+        device->sysfsID_ = fields[5].str();
+        device->className_ = fields[6].str();
+        device->vendorName_ = fields[7].str();
+        device->deviceName_ = fields[8].str();
+        devices_.push_back(device);
+    }
+}
+
+void FixtureDeviceSource::fillDevices(MHWD::BUS type,
+        std::vector<std::shared_ptr<Device>>& devices) const
+{
+    for (const auto& device : devices_)
+    {
+        if (type == device->type_)
+        {
+            // Hand out copies, Data attaches its configs to them
+            devices.emplace_back(new Device(*device));
+        }
+    }
+}
+
+void FixtureDeviceSource::write(std::ostream& out, const std::vector<std::shared_ptr<Device>>& devices)
+{
+    for (const auto& device : devices)
+    {
+        out << MHWD::busName(device->type_) << '|' << device->classID_ << '|' << device->vendorID_ << '|'
+                << device->deviceID_ << '|' << device->sysfsBusID_ << '|' << device->sysfsID_ << '|'
+                << device->className_ << '|' << device->vendorName_ << '|' << device->deviceName_
+                << '\n';
+    }
+}
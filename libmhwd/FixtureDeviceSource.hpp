@@ -0,0 +1,59 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FIXTUREDEVICESOURCE_HPP_
+#define FIXTUREDEVICESOURCE_HPP_
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "DeviceSource.hpp"
+
+/*
+ * Reads devices from a fixture file instead of probing the hardware.
+ * One device per line, fields separated by '|':
+ *
+ *   BUS|CLASSID|VENDORID|DEVICEID|SYSFSBUSID|SYSFSID|CLASSNAME|VENDORNAME|DEVICENAME
+ *
+ * BUS is PCI or USB, ids are hex without prefix. Trailing fields may be
+ * omitted; empty lines and lines starting with '#' are ignored.
+ */
+class FixtureDeviceSource : public DeviceSource
+{
+public:
+    explicit FixtureDeviceSource(const std::string& fixturePath);
+
+    void fillDevices(MHWD::BUS type,
+            std::vector<std::shared_ptr<Device>>& devices) const override;
+
+    static void write(std::ostream& out, const std::vector<std::shared_ptr<Device>>& devices);
+
+private:
+    std::vector<std::shared_ptr<Device>> devices_;
+};
+
+#endif /* FIXTUREDEVICESOURCE_HPP_ */
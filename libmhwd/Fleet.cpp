@@ -0,0 +1,162 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Fleet.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FixtureDeviceSource.hpp"
+#include "Profiler.hpp"
+
+Fleet::Fleet(const Data& database, const AutoConfigure& autoConfigure)
+    : database_(database), autoConfigure_(autoConfigure)
+{
+    database_.PCIDevices.clear();
+    database_.USBDevices.clear();
+    database_.installedPCIConfigs.clear();
+    database_.installedUSBConfigs.clear();
+}
+
+Fleet::Result Fleet::evaluate(const std::string& profilePath) const
+{
+    Result result;
+    result.profilePath = profilePath;
+
+    try
+    {
+        // Configs are shared with the database, only the devices are new
+        Data data{database_};
+        data.setDevices(FixtureDeviceSource{profilePath});
+        result.selections = autoConfigure_.select(data);
+        result.unmatchedClassIDs = autoConfigure_.unmatchedClassIDs(data);
+    }
+    catch(const std::runtime_error& e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+void Fleet::evaluate(const std::vector<std::string>& profilePaths, unsigned int threads,
+        const std::function<void(const Result&)>& report) const
+{
+    Profiler::ScopedTimer timer("Fleet::evaluate");
+    std::atomic<std::size_t> next{0};
+    std::mutex reportMutex;
+
+    auto worker = [&]() {
+        for (std::size_t i = next++; i < profilePaths.size(); i = next++)
+        {
+            const Result result{evaluate(profilePaths[i])};
+            std::lock_guard<std::mutex> lock(reportMutex);
+            report(result);
+        }
+    };
+
+    threads = std::max(1u, std::min<unsigned int>(threads, profilePaths.size()));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < threads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers)
+    {
+        thread.join();
+    }
+}
+
+std::vector<std::string> Fleet::expandProfilePaths(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> profilePaths;
+
+    for (const auto& path : paths)
+    {
+        struct stat pathStat;
+        if ((0 != stat(path.c_str(), &pathStat)) || !S_ISDIR(pathStat.st_mode))
+        {
+            // Unreadable files end up as a failed result
+            profilePaths.push_back(path);
+            continue;
+        }
+
+        DIR *dir = opendir(path.c_str());
+        if (nullptr == dir)
+        {
+            throw std::runtime_error{"failed to read directory '" + path + "'"};
+        }
+
+        std::vector<std::string> dirProfiles;
+        struct dirent *dirEntry;
+        while (nullptr != (dirEntry = readdir(dir)))
+        {
+            const std::string filePath{path + "/" + dirEntry->d_name};
+            struct stat fileStat;
+            if ((0 == stat(filePath.c_str(), &fileStat)) && S_ISREG(fileStat.st_mode))
+            {
+                dirProfiles.push_back(filePath);
+            }
+        }
+        closedir(dir);
+
+        std::sort(dirProfiles.begin(), dirProfiles.end());
+        profilePaths.insert(profilePaths.end(), dirProfiles.begin(), dirProfiles.end());
+    }
+
+    return profilePaths;
+}
+
+void Fleet::write(std::ostream& out, const Result& result)
+{
+    // PROFILE|BUS|SYSFSBUSID|CLASSID:VENDORID:DEVICEID|CONFIG, CONFIG empty if none matched
+    if (!result.error.empty())
+    {
+        out << result.profilePath << "|error|" << result.error << '\n';
+        return;
+    }
+
+    for (const auto& selection : result.selections)
+    {
+        const Device& device = *selection.device;
+        out << result.profilePath << '|' << MHWD::busName(device.type_) << '|' << device.sysfsBusID_ << '|'
+                << device.classID_ << ':' << device.vendorID_ << ':' << device.deviceID_ << '|'
+                << (selection.config ? selection.config->name_ : "") << '\n';
+    }
+    for (const auto& classID : result.unmatchedClassIDs)
+    {
+        out << result.profilePath << "|unmatched|" << classID << '\n';
+    }
+}
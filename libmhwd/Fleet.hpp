@@ -0,0 +1,69 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef FLEET_HPP_
+#define FLEET_HPP_
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "AutoConfigure.hpp"
+#include "Data.hpp"
+
+/*
+ * Runs the -a/--auto selection for many recorded hardware profiles
+ * (fixture files) against one parsed database, spread over threads.
+ * Profiles are evaluated as fresh installs: no config counts as installed.
+ */
+class Fleet
+{
+public:
+    struct Result
+    {
+        std::string profilePath;
+        std::vector<AutoConfigure::Selection> selections;
+        std::vector<std::string> unmatchedClassIDs;
+        std::string error;
+    };
+
+    Fleet(const Data& database, const AutoConfigure& autoConfigure);
+
+    Result evaluate(const std::string& profilePath) const;
+    // report is called once per profile, in completion order, never concurrently
+    void evaluate(const std::vector<std::string>& profilePaths, unsigned int threads,
+            const std::function<void(const Result&)>& report) const;
+
+    // Directories are replaced by the regular files they contain, sorted
+    static std::vector<std::string> expandProfilePaths(const std::vector<std::string>& paths);
+    static void write(std::ostream& out, const Result& result);
+
+private:
+    Data database_;
+    AutoConfigure autoConfigure_;
+};
+
+#endif /* FLEET_HPP_ */
@@ -0,0 +1,270 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "GpuStatus.hpp"
+
+#include <limits.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Profiler.hpp"
+#include "Utils.hpp"
+#include "vita/string.hpp"
+
+namespace
+{
+    const char* const PROC_MODULES = "/proc/modules";
+    const char* const SYSFS_PCI_DEVICES = "/sys/bus/pci/devices";
+    const char* const HEADING = "##\n## Generated by mhwd - Manjaro Hardware Detection\n##\n \n";
+
+    std::string readLink(const std::string& path)
+    {
+        char target[PATH_MAX];
+        const ssize_t size = readlink(path.c_str(), target, sizeof(target));
+        return (size < 0) ? std::string{} : std::string(target, size);
+    }
+
+    std::string readFirstLine(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    bool isModuleName(const std::string& module)
+    {
+        return !module.empty() && std::all_of(module.begin(), module.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || ('_' == c) || ('-' == c);
+        });
+    }
+}
+
+GpuStatus::GpuStatus()
+{
+    Profiler::ScopedTimer timer("GpuStatus::GpuStatus");
+
+    struct stat status;
+    if ((0 == lstat(xorgConfigPath.c_str(), &status)) && S_ISLNK(status.st_mode))
+    {
+        xorgConfigTarget = readLink(xorgConfigPath);
+    }
+    xorgConfigExists = (0 == stat(xorgConfigPath.c_str(), &status));
+
+    const std::unordered_set<std::string> loaded{loadedModules()};
+
+    std::ifstream file(MHWD_GPU_MODULES_LOAD);
+    Vita::string line;
+    while (std::getline(file, line))
+    {
+        line.trimInPlace();
+        if (!line.empty() && ('#' != line[0]))
+        {
+            modules.push_back(Module{line, loaded.count(normalizeModule(line)) > 0});
+        }
+    }
+
+    readBlacklist(loaded);
+    readGpus();
+}
+
+void GpuStatus::write(std::ostream& out, const GpuStatus& status)
+{
+    out << ":: status\n";
+    if (status.xorgConfigExists)
+    {
+        out << "  xorg configuration file: '" << status.xorgConfigTarget << "'\n";
+    }
+    else
+    {
+        out << "warning: could not find '" << status.xorgConfigPath << "'!\n";
+    }
+
+    for (const auto& module : status.modules)
+    {
+        out << "  module: " << module.name << (module.loaded ? " (loaded)" : " (not loaded)") << '\n';
+    }
+    for (const auto& entry : status.blacklist)
+    {
+        out << "  blacklisted: " << entry.module << (entry.loaded ? " (loaded)" : "")
+                << " in " << entry.file << '\n';
+    }
+    for (const auto& gpu : status.gpus)
+    {
+        out << "  gpu: " << gpu.sysfsBusID << " (" << gpu.classID << ':' << gpu.vendorID << ':'
+                << gpu.deviceID << ") driver: " << (gpu.driver.empty() ? "none" : gpu.driver) << '\n';
+    }
+}
+
+bool GpuStatus::removeInvalidXorgConfig()
+{
+    struct stat status;
+    const std::string path{MHWD_XORG_CONFIG};
+    if ((0 == lstat(path.c_str(), &status)) && S_ISLNK(status.st_mode)
+            && (0 != stat(path.c_str(), &status)))
+    {
+        return 0 == unlink(path.c_str());
+    }
+    return true;
+}
+
+bool GpuStatus::setModules(const std::vector<std::string>& modules,
+        const std::vector<std::string>& blacklistedModules)
+{
+    if (!std::all_of(modules.begin(), modules.end(), isModuleName)
+            || !std::all_of(blacklistedModules.begin(), blacklistedModules.end(), isModuleName))
+    {
+        return false;
+    }
+
+    std::string blacklist{HEADING};
+    std::string rmmod{"rmmod -f"};
+    for (const auto& module : blacklistedModules)
+    {
+        blacklist += "blacklist " + module + "\n";
+        rmmod += " " + module;
+    }
+
+    std::string load{HEADING};
+    std::string modprobe{"modprobe -a"};
+    for (const auto& module : modules)
+    {
+        load += module + "\n";
+        modprobe += " " + module;
+    }
+
+    if (!MhwdUtils::writeFileAtomically(MHWD_GPU_MODPROBE_CONFIG, blacklist) || !MhwdUtils::writeFileAtomically(MHWD_GPU_MODULES_LOAD, load))
+    {
+        return false;
+    }
+
+    // Like the shell version, failing to (un)load a module is not an error
+    if (!isXRunning())
+    {
+        if (!blacklistedModules.empty())
+        {
+            Profiler::instance().count(Profiler::COUNTER::CHILD_PROCESSES);
+            static_cast<void>(std::system(rmmod.c_str()));
+        }
+        if (!modules.empty())
+        {
+            Profiler::instance().count(Profiler::COUNTER::CHILD_PROCESSES);
+            static_cast<void>(std::system(modprobe.c_str()));
+        }
+    }
+    return true;
+}
+
+std::unordered_set<std::string> GpuStatus::loadedModules()
+{
+    std::unordered_set<std::string> loaded;
+    std::ifstream file(PROC_MODULES);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        loaded.insert(line.substr(0, line.find(' ')));
+    }
+    return loaded;
+}
+
+std::string GpuStatus::normalizeModule(std::string module)
+{
+    // The kernel lists modules with '_', modprobe accepts both
+    std::replace(module.begin(), module.end(), '-', '_');
+    return module;
+}
+
+bool GpuStatus::isXRunning()
+{
+    // What `pgrep X` checks: any process name containing an X
+    for (const auto& entry : MhwdUtils::listDirectory("/proc"))
+    {
+        if (std::isdigit(static_cast<unsigned char>(entry[0]))
+                && (std::string::npos != readFirstLine("/proc/" + entry + "/comm").find('X')))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GpuStatus::readBlacklist(const std::unordered_set<std::string>& loaded)
+{
+    const std::string directory{MHWD_MODPROBE_DIR};
+    for (const auto& name : MhwdUtils::listDirectory(directory))
+    {
+        // Like modprobe, skip hidden files such as editor swap files
+        if ('.' == name[0])
+        {
+            continue;
+        }
+        const std::string path{directory + "/" + name};
+        std::ifstream file(path);
+        Vita::string line;
+        while (std::getline(file, line))
+        {
+            line.trimInPlace();
+            if (0 != line.compare(0, 10, "blacklist ") && 0 != line.compare(0, 10, "blacklist\t"))
+            {
+                continue;
+            }
+            const std::string module{Vita::string(line.substr(10)).trim()};
+            blacklist.push_back(BlacklistEntry{module, path, loaded.count(normalizeModule(module)) > 0});
+        }
+    }
+}
+
+void GpuStatus::readGpus()
+{
+    const std::string directory{SYSFS_PCI_DEVICES};
+    for (const auto& busID : MhwdUtils::listDirectory(directory))
+    {
+        const std::string path{directory + "/" + busID};
+
+        // Sysfs class is 0xBBSSPP: base class, sub class, programming interface
+        const std::string pciClass{readFirstLine(path + "/class")};
+        if ((pciClass.size() < 6) || (0 != pciClass.compare(0, 4, "0x03")))
+        {
+            continue;
+        }
+
+        Gpu gpu;
+        gpu.sysfsBusID = busID;
+        gpu.classID = pciClass.substr(2, 4);
+        gpu.vendorID = readFirstLine(path + "/vendor").substr(2);
+        gpu.deviceID = readFirstLine(path + "/device").substr(2);
+        const std::string driver{readLink(path + "/driver")};
+        gpu.driver = driver.substr(driver.rfind('/') + 1);
+        gpus.push_back(gpu);
+    }
+}
@@ -0,0 +1,97 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GPUSTATUS_HPP_
+#define GPUSTATUS_HPP_
+
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "const.h"
+
+/*
+ * The graphics setup mhwd-gpu manages, read from /etc, /proc and /sys
+ * instead of running readlink, pgrep and lsmod: the target of 90-mhwd.conf,
+ * the modules mhwd-gpu loads, every blacklisted module and the driver bound
+ * to each display controller.
+ */
+class GpuStatus
+{
+public:
+    struct Module
+    {
+        std::string name;
+        bool loaded;
+    };
+
+    struct BlacklistEntry
+    {
+        std::string module;
+        std::string file;
+        bool loaded;
+    };
+
+    struct Gpu
+    {
+        std::string sysfsBusID;
+        std::string classID;
+        std::string vendorID;
+        std::string deviceID;
+        // Empty if no driver is bound
+        std::string driver;
+    };
+
+    GpuStatus();
+
+    std::string xorgConfigPath {MHWD_XORG_CONFIG};
+    // Empty if the xorg config is no symlink
+    std::string xorgConfigTarget;
+    // Following the symlink, like test -e
+    bool xorgConfigExists = false;
+    std::vector<Module> modules;
+    std::vector<BlacklistEntry> blacklist;
+    std::vector<Gpu> gpus;
+
+    static void write(std::ostream& out, const GpuStatus& status);
+
+    // Removes the xorg config if it is a symlink pointing nowhere
+    static bool removeInvalidXorgConfig();
+    // Writes the modprobe.d blacklist and the modules-load.d list in one
+    // atomic write each. Unless X runs, the blacklisted modules are then
+    // unloaded with one rmmod and the others loaded with one modprobe.
+    static bool setModules(const std::vector<std::string>& modules,
+            const std::vector<std::string>& blacklistedModules);
+
+private:
+    static std::unordered_set<std::string> loadedModules();
+    static std::string normalizeModule(std::string module);
+    static bool isXRunning();
+    void readBlacklist(const std::unordered_set<std::string>& loaded);
+    void readGpus();
+};
+
+#endif /* GPUSTATUS_HPP_ */
@@ -0,0 +1,100 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "HardwareDeviceSource.hpp"
+
+#include <hd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Profiler.hpp"
+
+HardwareDeviceSource::HardwareDeviceSource(bool fullProbe)
+    : fullProbe_(fullProbe)
+{}
+
+void HardwareDeviceSource::fillDevices(MHWD::BUS type,
+        std::vector<std::shared_ptr<Device>>& devices) const
+{
+    const hw_item hw = (MHWD::BUS::USB == type) ? hw_usb : hw_pci;
+
+    // Get the hardware devices
+    std::unique_ptr<hd_data_t> hd_data{new hd_data_t()};
+    hd_t *hd = nullptr;
+    if (fullProbe_)
+    {
+        Profiler::ScopedTimer timer(std::string{"HardwareDeviceSource::probe("} + MHWD::busName(type) + ", full)");
+        hd = hd_list(hd_data.get(), hw, 1, nullptr);
+    }
+    else
+    {
+        Profiler::ScopedTimer timer(std::string{"HardwareDeviceSource::probe("} + MHWD::busName(type) + ", fast)");
+        hd_data->flags.fast = 1;
+        hd_clear_probe_feature(hd_data.get(), pr_all);
+        hd_set_probe_feature(hd_data.get(), (MHWD::BUS::USB == type) ? pr_usb : pr_pci);
+        hd_scan(hd_data.get());
+        // Without rescan hd_list only picks the bus devices from the scan
+        hd = hd_list(hd_data.get(), hw, 0, nullptr);
+    }
+
+    std::unique_ptr<Device> device;
+    for (hd_t *hdIter = hd; hdIter; hdIter = hdIter->next)
+    {
+        device.reset(new Device());
+        device->type_ = type;
+        device->classID_ = from_Hex(hdIter->base_class.id, 2) + from_Hex(hdIter->sub_class.id, 2);
+        device->vendorID_ = from_Hex(hdIter->vendor.id, 4);
+        device->deviceID_ = from_Hex(hdIter->device.id, 4);
+        device->className_ = from_CharArray(hdIter->base_class.name);
+        device->vendorName_ = from_CharArray(hdIter->vendor.name);
+        device->deviceName_ = from_CharArray(hdIter->device.name);
+        device->sysfsBusID_ = from_CharArray(hdIter->sysfs_bus_id);
+        device->sysfsID_ = from_CharArray(hdIter->sysfs_id);
+        devices.emplace_back(device.release());
+    }
+
+    hd_free_hd_list(hd);
+    hd_free_hd_data(hd_data.get());
+}
+
+Vita::string HardwareDeviceSource::from_Hex(std::uint16_t hexnum, int fill) const
+{
+    // Lower case, like the ids in the configs
+    Vita::string hex;
+    Vita::string::appendNumber(hex, hexnum, 16, fill);
+    return hex;
+}
+
+std::string HardwareDeviceSource::from_CharArray(char* c) const
+{
+    if (nullptr == c)
+    {
+        return "";
+    }
+
+    return std::string(c);
+}
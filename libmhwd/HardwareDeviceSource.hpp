@@ -0,0 +1,59 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef HARDWAREDEVICESOURCE_HPP_
+#define HARDWAREDEVICESOURCE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DeviceSource.hpp"
+#include "vita/string.hpp"
+
+/*
+ * Probes the devices of the running system with libhd. By default only the
+ * bus itself is scanned, which is all the ids, names and sysfs paths of a
+ * Device need; fullProbe runs every probe libhd would run for the bus.
+ */
+class HardwareDeviceSource : public DeviceSource
+{
+public:
+    explicit HardwareDeviceSource(bool fullProbe = false);
+
+    void fillDevices(MHWD::BUS type,
+            std::vector<std::shared_ptr<Device>>& devices) const override;
+    // libhd keeps global state, so only one bus can be probed at a time
+    bool concurrentFill() const override { return false; }
+
+private:
+    bool fullProbe_;
+
+    Vita::string from_Hex(std::uint16_t hexnum, int fill) const;
+    std::string from_CharArray(char* c) const;
+};
+
+#endif /* HARDWAREDEVICESOURCE_HPP_ */
@@ -0,0 +1,54 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "InternedString.hpp"
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+InternedString::InternedString()
+{
+    static const std::string* const emptyString = intern("");
+    str_ = emptyString;
+}
+
+InternedString::InternedString(const std::string& str)
+    : str_(intern(str))
+{}
+
+InternedString::InternedString(const char* str)
+    : str_(intern(str))
+{}
+
+const std::string* InternedString::intern(const std::string& str)
+{
+    // Elements of an unordered_set keep their address when it grows
+    static std::unordered_set<std::string> pool;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return &*pool.insert(str).first;
+}
@@ -0,0 +1,77 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INTERNEDSTRING_HPP_
+#define INTERNEDSTRING_HPP_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+/*
+ * Immutable string sharing its characters with every equal InternedString
+ * of the process. Device names and ids repeat a lot between devices and
+ * configs: each value is stored once and == is a pointer compare. The pool
+ * is never emptied, so only intern values that come from a bounded set.
+ */
+class InternedString
+{
+public:
+    InternedString();
+    InternedString(const std::string& str);
+    InternedString(const char* str);
+
+    const std::string& str() const { return *str_; }
+    operator const std::string&() const { return *str_; }
+    const char* c_str() const { return str_->c_str(); }
+    bool empty() const { return str_->empty(); }
+    std::size_t size() const { return str_->size(); }
+
+    bool operator==(const InternedString& other) const { return str_ == other.str_; }
+    bool operator!=(const InternedString& other) const { return str_ != other.str_; }
+
+private:
+    static const std::string* intern(const std::string& str);
+
+    const std::string* str_;
+};
+
+inline bool operator==(const InternedString& lhs, const std::string& rhs) { return lhs.str() == rhs; }
+inline bool operator==(const std::string& lhs, const InternedString& rhs) { return lhs == rhs.str(); }
+inline bool operator==(const InternedString& lhs, const char* rhs) { return lhs.str() == rhs; }
+inline bool operator==(const char* lhs, const InternedString& rhs) { return lhs == rhs.str(); }
+inline bool operator!=(const InternedString& lhs, const std::string& rhs) { return lhs.str() != rhs; }
+inline bool operator!=(const std::string& lhs, const InternedString& rhs) { return lhs != rhs.str(); }
+inline bool operator!=(const InternedString& lhs, const char* rhs) { return lhs.str() != rhs; }
+inline bool operator!=(const char* lhs, const InternedString& rhs) { return lhs != rhs.str(); }
+
+inline std::string operator+(const std::string& lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const InternedString& lhs, const std::string& rhs) { return lhs.str() + rhs; }
+inline std::string operator+(const char* lhs, const InternedString& rhs) { return lhs + rhs.str(); }
+inline std::string operator+(const InternedString& lhs, const char* rhs) { return lhs.str() + rhs; }
+
+inline std::ostream& operator<<(std::ostream& out, const InternedString& str) { return out << str.str(); }
+
+#endif /* INTERNEDSTRING_HPP_ */
@@ -0,0 +1,225 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "KernelPlanner.hpp"
+
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "PackagePlanner.hpp"
+#include "Profiler.hpp"
+#include "vita/string.hpp"
+
+KernelPlanner::KernelPlanner(const std::string& PMRootPath, const std::string& PMConfigPath)
+    : installed_(PackagePlanner::readLocalDatabase(PMRootPath))
+{
+    Profiler::ScopedTimer timer("KernelPlanner::KernelPlanner");
+
+    // Package names of all sync databases, one per line
+    const std::string cmd{"exec pacman --config \"" + PMConfigPath + "\" --root \"" + PMRootPath
+            + "\" -Slq 2>/dev/null"};
+    Profiler::instance().count(Profiler::COUNTER::CHILD_PROCESSES);
+    FILE *in = popen(cmd.c_str(), "r");
+    if (nullptr == in)
+    {
+        throw std::runtime_error{"failed to run pacman"};
+    }
+
+    char buff[512];
+    while (nullptr != fgets(buff, sizeof(buff), in))
+    {
+        Vita::string package{buff};
+        package.trimInPlace();
+        if (!package.empty())
+        {
+            available_.insert(package);
+        }
+    }
+
+    if (0 != pclose(in))
+    {
+        throw std::runtime_error{"failed to read the pacman sync databases"};
+    }
+}
+
+bool KernelPlanner::isKernel(const std::string& package)
+{
+    // What the script matches with linux[0-9][0-9]?([0-9]) and linux[0-9][0-9]?([0-9])-rt
+    const std::string prefix{"linux"};
+    std::size_t end = package.size();
+    if ((end > 3) && (0 == package.compare(end - 3, 3, "-rt")))
+    {
+        end -= 3;
+    }
+    if ((0 != package.compare(0, prefix.size(), prefix))
+            || (end < prefix.size() + 2) || (end > prefix.size() + 3))
+    {
+        return false;
+    }
+    return std::all_of(package.begin() + prefix.size(), package.begin() + end, [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
+}
+
+std::string KernelPlanner::runningKernel()
+{
+    struct utsname name;
+    if (0 != uname(&name))
+    {
+        return "";
+    }
+
+    const std::vector<Vita::string> version{Vita::string(name.release).explode(".")};
+    return (version.size() < 2) ? std::string{} : "linux" + version[0] + version[1];
+}
+
+std::vector<std::string> KernelPlanner::installedKernels() const
+{
+    std::unordered_set<std::string> kernels;
+    for (const auto& package : installed_)
+    {
+        if (isKernel(package))
+        {
+            kernels.insert(package);
+        }
+    }
+    return sorted(kernels);
+}
+
+std::vector<std::string> KernelPlanner::availableKernels() const
+{
+    std::unordered_set<std::string> kernels;
+    for (const auto& package : available_)
+    {
+        if (isKernel(package))
+        {
+            kernels.insert(package);
+        }
+    }
+    return sorted(kernels);
+}
+
+std::vector<std::string> KernelPlanner::installPackages(const std::vector<std::string>& kernels,
+        const std::string& currentKernel) const
+{
+    const std::vector<std::string> installed{sorted(installed_)};
+    std::vector<std::string> packages;
+    std::unordered_set<std::string> seen;
+
+    for (const auto& kernel : kernels)
+    {
+        checkKernel(kernel, currentKernel);
+        if (available_.find(kernel) == available_.end())
+        {
+            throw std::runtime_error{"kernel '" + kernel + "' is not in the sync databases!"};
+        }
+
+        // linux61-nvidia becomes linux66-nvidia, if that exists
+        for (const auto& package : installed)
+        {
+            if (!isPackageOf(package, currentKernel))
+            {
+                continue;
+            }
+            const std::string counterpart{kernel + package.substr(currentKernel.size())};
+            if ((available_.find(counterpart) != available_.end()) && seen.insert(counterpart).second)
+            {
+                packages.push_back(counterpart);
+            }
+        }
+        if (seen.insert(kernel).second)
+        {
+            packages.push_back(kernel);
+        }
+    }
+
+    return packages;
+}
+
+std::vector<std::string> KernelPlanner::removePackages(const std::vector<std::string>& kernels,
+        const std::string& currentKernel) const
+{
+    const std::vector<std::string> installed{sorted(installed_)};
+    std::vector<std::string> packages;
+    std::unordered_set<std::string> seen;
+
+    for (const auto& kernel : kernels)
+    {
+        checkKernel(kernel, currentKernel);
+        if (installed_.find(kernel) == installed_.end())
+        {
+            throw std::runtime_error{"kernel '" + kernel + "' is not installed!"};
+        }
+
+        for (const auto& package : installed)
+        {
+            if (isPackageOf(package, kernel) && seen.insert(package).second)
+            {
+                packages.push_back(package);
+            }
+        }
+    }
+
+    return packages;
+}
+
+bool KernelPlanner::isPackageOf(const std::string& package, const std::string& kernel)
+{
+    if ((0 != package.compare(0, kernel.size(), kernel))
+            || ((package.size() != kernel.size()) && ('-' != package[kernel.size()])))
+    {
+        return false;
+    }
+
+    // linux61-rt and its packages belong to the realtime kernel, not to linux61
+    const std::string suffix{package.substr(kernel.size())};
+    return (0 != suffix.compare(0, 3, "-rt")) || ((suffix.size() > 3) && ('-' != suffix[3]));
+}
+
+std::vector<std::string> KernelPlanner::sorted(const std::unordered_set<std::string>& packages)
+{
+    std::vector<std::string> list(packages.begin(), packages.end());
+    std::sort(list.begin(), list.end());
+    return list;
+}
+
+void KernelPlanner::checkKernel(const std::string& kernel, const std::string& currentKernel)
+{
+    if (!isKernel(kernel))
+    {
+        throw std::runtime_error{"'" + kernel + "' is no valid kernel name!"};
+    }
+    if (kernel == currentKernel)
+    {
+        throw std::runtime_error{"kernel '" + kernel + "' is the running kernel!"};
+    }
+}
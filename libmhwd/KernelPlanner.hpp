@@ -0,0 +1,70 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef KERNELPLANNER_HPP_
+#define KERNELPLANNER_HPP_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * What mhwd-kernel installs and removes, worked out from one read of the
+ * local pacman database and one `pacman -Slq` instead of a pacman search
+ * per package. Kernels are named linuxXY[Z] or linuxXY[Z]-rt, the packages
+ * of a kernel are the kernel itself and every <kernel>-<name> package,
+ * except those of its -rt kernel.
+ */
+class KernelPlanner
+{
+public:
+    KernelPlanner(const std::string& PMRootPath, const std::string& PMConfigPath);
+
+    static bool isKernel(const std::string& package);
+    // "linux61" for 6.1.x, the way the script names the running kernel
+    static std::string runningKernel();
+
+    std::vector<std::string> installedKernels() const;
+    std::vector<std::string> availableKernels() const;
+    // Every kernel with the counterparts of the packages installed for
+    // currentKernel, for one pacman -S. Throws if a kernel is invalid,
+    // the current one or not in the sync databases.
+    std::vector<std::string> installPackages(const std::vector<std::string>& kernels,
+            const std::string& currentKernel) const;
+    // All installed packages of the kernels, for one pacman -R. Throws if
+    // a kernel is invalid, the current one or not installed.
+    std::vector<std::string> removePackages(const std::vector<std::string>& kernels,
+            const std::string& currentKernel) const;
+
+private:
+    static bool isPackageOf(const std::string& package, const std::string& kernel);
+    static std::vector<std::string> sorted(const std::unordered_set<std::string>& packages);
+    static void checkKernel(const std::string& kernel, const std::string& currentKernel);
+
+    std::unordered_set<std::string> installed_;
+    std::unordered_set<std::string> available_;
+};
+
+#endif /* KERNELPLANNER_HPP_ */
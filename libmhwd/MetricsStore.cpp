@@ -0,0 +1,247 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MetricsStore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Utils.hpp"
+
+namespace
+{
+    // Prometheus label values are quoted, so quotes, backslashes and newlines are escaped
+    std::string labelValue(const std::string& value)
+    {
+        std::string escaped;
+        for (const char c : value)
+        {
+            switch (c)
+            {
+                case '\\':
+                    escaped += "\\\\";
+                    break;
+                case '"':
+                    escaped += "\\\"";
+                    break;
+                case '\n':
+                    escaped += "\\n";
+                    break;
+                default:
+                    escaped += c;
+                    break;
+            }
+        }
+        return escaped;
+    }
+
+    std::string seconds(double value)
+    {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(6) << value;
+        return out.str();
+    }
+
+    // Nearest rank, samples sorted
+    double quantile(const std::vector<double>& sorted, double q)
+    {
+        const std::size_t rank = static_cast<std::size_t>(std::ceil(q * sorted.size()));
+        return sorted[(rank > 0) ? rank - 1 : 0];
+    }
+}
+
+MetricsStore::MetricsStore(const std::string& path)
+    : path_(path)
+{}
+
+void MetricsStore::add(const std::string& root, const std::string& config,
+        const std::string& phase, double seconds, int exitCode)
+{
+    Sample sample;
+    sample.timestamp = static_cast<long long>(std::time(nullptr));
+    sample.root = root;
+    sample.config = config;
+    sample.phase = phase;
+    sample.seconds = seconds;
+    sample.exitCode = exitCode;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.push_back(sample);
+}
+
+bool MetricsStore::save(std::size_t maxSamples)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (samples_.empty())
+    {
+        return true;
+    }
+
+    std::vector<Sample> samples{load()};
+    samples.insert(samples.end(), samples_.begin(), samples_.end());
+    samples_.clear();
+    if (samples.size() > maxSamples)
+    {
+        samples.erase(samples.begin(), samples.end() - maxSamples);
+    }
+
+    std::ostringstream history;
+    history << "# mhwd metrics: timestamp|root|config|phase|seconds|exit code\n";
+    for (const auto& sample : samples)
+    {
+        history << sample.timestamp << '|' << sample.root << '|' << sample.config << '|'
+                << sample.phase << '|' << seconds(sample.seconds) << '|'
+                << sample.exitCode << '\n';
+    }
+
+    // The exporter never reads half a history
+    return MhwdUtils::writeFileAtomically(path_, history.str());
+}
+
+std::vector<MetricsStore::Sample> MetricsStore::load() const
+{
+    std::vector<Sample> samples;
+    std::ifstream file(path_);
+    std::string line;
+
+    while (std::getline(file, line))
+    {
+        if (line.empty() || ('#' == line[0]))
+        {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        std::string timestamp, secs, exitCode;
+        Sample sample;
+        if (!std::getline(fields, timestamp, '|') || !std::getline(fields, sample.root, '|')
+                || !std::getline(fields, sample.config, '|')
+                || !std::getline(fields, sample.phase, '|')
+                || !std::getline(fields, secs, '|') || !std::getline(fields, exitCode))
+        {
+            continue;
+        }
+
+        try
+        {
+            sample.timestamp = std::stoll(timestamp);
+            sample.seconds = std::stod(secs);
+            sample.exitCode = std::stoi(exitCode);
+        }
+        catch(const std::logic_error&)
+        {
+            continue;
+        }
+        samples.push_back(sample);
+    }
+
+    return samples;
+}
+
+void MetricsStore::writeTextfile(std::ostream& out, const std::vector<Sample>& samples)
+{
+    // Samples are stored oldest first, so the last one of each series is the latest run
+    std::map<std::tuple<std::string, std::string, std::string>, std::vector<const Sample*>> series;
+    for (const auto& sample : samples)
+    {
+        series[std::make_tuple(sample.root, sample.config, sample.phase)].push_back(&sample);
+    }
+
+    std::map<std::tuple<std::string, std::string, std::string>, std::string> labels;
+    for (const auto& entry : series)
+    {
+        labels[entry.first] = "root=\"" + labelValue(std::get<0>(entry.first))
+                + "\",config=\"" + labelValue(std::get<1>(entry.first))
+                + "\",phase=\"" + labelValue(std::get<2>(entry.first)) + "\"";
+    }
+
+    out << "# HELP mhwd_phase_last_duration_seconds Duration of the latest run of the phase.\n"
+            << "# TYPE mhwd_phase_last_duration_seconds gauge\n";
+    for (const auto& entry : series)
+    {
+        out << "mhwd_phase_last_duration_seconds{" << labels[entry.first] << "} "
+                << seconds(entry.second.back()->seconds) << '\n';
+    }
+
+    out << "# HELP mhwd_phase_last_exit_code Exit code of the latest run of the phase.\n"
+            << "# TYPE mhwd_phase_last_exit_code gauge\n";
+    for (const auto& entry : series)
+    {
+        out << "mhwd_phase_last_exit_code{" << labels[entry.first] << "} "
+                << entry.second.back()->exitCode << '\n';
+    }
+
+    out << "# HELP mhwd_phase_last_run_timestamp_seconds Time the latest run of the phase ended.\n"
+            << "# TYPE mhwd_phase_last_run_timestamp_seconds gauge\n";
+    for (const auto& entry : series)
+    {
+        out << "mhwd_phase_last_run_timestamp_seconds{" << labels[entry.first] << "} "
+                << entry.second.back()->timestamp << '\n';
+    }
+
+    // The history is rolling, so these go down as old runs drop out: gauges, not counters
+    out << "# HELP mhwd_phase_duration_seconds Duration quantiles of the recorded runs of the phase.\n"
+            << "# TYPE mhwd_phase_duration_seconds gauge\n";
+    for (const auto& entry : series)
+    {
+        std::vector<double> durations;
+        for (const auto* sample : entry.second)
+        {
+            durations.push_back(sample->seconds);
+        }
+        std::sort(durations.begin(), durations.end());
+
+        for (const char* q : {"0.5", "0.9", "1"})
+        {
+            out << "mhwd_phase_duration_seconds{" << labels[entry.first] << ",quantile=\"" << q
+                    << "\"} " << seconds(quantile(durations, std::stod(q))) << '\n';
+        }
+    }
+
+    out << "# HELP mhwd_phase_runs Recorded runs of the phase.\n"
+            << "# TYPE mhwd_phase_runs gauge\n";
+    for (const auto& entry : series)
+    {
+        out << "mhwd_phase_runs{" << labels[entry.first] << "} " << entry.second.size() << '\n';
+    }
+
+    out << "# HELP mhwd_phase_failures Recorded runs of the phase with a non-zero exit code.\n"
+            << "# TYPE mhwd_phase_failures gauge\n";
+    for (const auto& entry : series)
+    {
+        out << "mhwd_phase_failures{" << labels[entry.first] << "} "
+                << std::count_if(entry.second.begin(), entry.second.end(),
+                        [](const Sample* sample) { return 0 != sample->exitCode; }) << '\n';
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef METRICSSTORE_HPP_
+#define METRICSSTORE_HPP_
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "const.h"
+
+/*
+ * Rolling history of how long the phases of past transactions took and
+ * how they ended, one line per sample in a small file below
+ * /var/lib/mhwd. Only the newest samples are kept. writeTextfile turns
+ * the history into metrics for the node-exporter textfile collector.
+ */
+class MetricsStore
+{
+public:
+    struct Sample
+    {
+        long long timestamp = 0;
+        std::string root;
+        // Empty for phases that cover the whole transaction
+        std::string config;
+        std::string phase;
+        double seconds = 0;
+        int exitCode = 0;
+    };
+
+    explicit MetricsStore(const std::string& path = MHWD_METRICS_STORE);
+
+    // Stamped with the current time; kept in memory until save()
+    void add(const std::string& root, const std::string& config, const std::string& phase,
+            double seconds, int exitCode);
+    // Appends the added samples and drops all but the newest maxSamples
+    bool save(std::size_t maxSamples = MHWD_METRICS_MAX_SAMPLES);
+    std::vector<Sample> load() const;
+
+    static void writeTextfile(std::ostream& out, const std::vector<Sample>& samples);
+
+private:
+    std::string path_;
+    std::mutex mutex_;
+    std::vector<Sample> samples_;
+};
+
+#endif /* METRICSSTORE_HPP_ */
@@ -0,0 +1,208 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ModaliasIndex.hpp"
+
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+ModaliasIndex::ModaliasIndex(const std::string& aliasFile)
+{
+    std::ifstream file(aliasFile);
+    if (!file)
+    {
+        throw std::runtime_error{"failed to read '" + aliasFile + "'"};
+    }
+    read(file);
+
+    // Built-in modules have no file for modinfo to read, their aliases are listed aside
+    const std::size_t dirEnd = aliasFile.rfind('/');
+    std::ifstream builtinFile((std::string::npos == dirEnd) ? "modules.builtin.alias"
+            : aliasFile.substr(0, dirEnd + 1) + "modules.builtin.alias");
+    if (builtinFile)
+    {
+        read(builtinFile);
+    }
+}
+
+void ModaliasIndex::read(std::istream& file)
+{
+    // Lines look like: alias pci:v000010DEd00001C82sv*sd*bc03sc00i* nvidia
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (0 != line.compare(0, 10, "alias pci:"))
+        {
+            continue;
+        }
+
+        const std::size_t aliasEnd = line.find(' ', 6);
+        if (std::string::npos == aliasEnd)
+        {
+            continue;
+        }
+        const std::size_t moduleStart = line.find_first_not_of(' ', aliasEnd);
+        if (std::string::npos == moduleStart)
+        {
+            continue;
+        }
+        const std::size_t moduleEnd = line.find_first_of(" \t\r", moduleStart);
+
+        ModuleIDs& ids = modules_[normalizeName(line.substr(moduleStart, moduleEnd - moduleStart))];
+        parsePCIAlias(line.substr(10, aliasEnd - 10), ids);
+    }
+}
+
+std::string ModaliasIndex::defaultAliasFile()
+{
+    struct utsname name;
+    if (0 != uname(&name))
+    {
+        throw std::runtime_error{"failed to get the kernel release"};
+    }
+    return std::string("/lib/modules/") + name.release + "/modules.alias";
+}
+
+bool ModaliasIndex::contains(const std::string& module) const
+{
+    return modules_.find(normalizeName(module)) != modules_.end();
+}
+
+ModaliasIndex::IDs ModaliasIndex::ids(const std::string& module) const
+{
+    IDs ids;
+    ids.module = module;
+
+    auto found = modules_.find(normalizeName(module));
+    if (found != modules_.end())
+    {
+        ids.classIDs = found->second.classIDs.values;
+        ids.vendorIDs = found->second.vendorIDs.values;
+        ids.deviceIDs = found->second.deviceIDs.values;
+    }
+    return ids;
+}
+
+void ModaliasIndex::write(std::ostream& out, const std::vector<IDs>& modules)
+{
+    for (const auto& ids : modules)
+    {
+        if (modules.size() > 1)
+        {
+            out << "# " << ids.module << '\n';
+        }
+        writeList(out, "CLASSIDS", ids.classIDs);
+        writeList(out, "VENDORIDS", ids.vendorIDs);
+        writeList(out, "DEVICEIDS", ids.deviceIDs);
+    }
+}
+
+void ModaliasIndex::IDList::add(const std::string& value)
+{
+    if (seen.insert(value).second)
+    {
+        values.push_back(value);
+    }
+}
+
+std::string ModaliasIndex::normalizeName(const std::string& module)
+{
+    // Like modinfo, take a module file for the module of that name
+    std::string name{module.substr(module.rfind('/') + 1)};
+    const std::size_t extension = name.find(".ko");
+    if ((std::string::npos != extension) && (extension > 0)
+            && ((name.size() == extension + 3) || ('.' == name[extension + 3])))
+    {
+        name.erase(extension);
+    }
+
+    // modprobe treats '-' and '_' in module names the same
+    std::replace(name.begin(), name.end(), '-', '_');
+    return name;
+}
+
+bool ModaliasIndex::parsePCIAlias(const std::string& alias, ModuleIDs& ids) const
+{
+    // v<vendor>d<device>sv<subvendor>sd<subdevice>bc<baseclass>sc<subclass>i<interface>
+    static const char* const fields[] = {"v", "d", "sv", "sd", "bc", "sc", "i"};
+    std::string values[7];
+    std::size_t pos = 0;
+
+    for (int field = 0; field < 7; ++field)
+    {
+        const std::size_t length = std::strlen(fields[field]);
+        if (0 != alias.compare(pos, length, fields[field]))
+        {
+            return false;
+        }
+        pos += length;
+
+        // Values are upper case hex or '*', the field names are lower case
+        std::size_t end = pos;
+        while ((end < alias.size()) && (std::isdigit(static_cast<unsigned char>(alias[end]))
+                || std::isupper(static_cast<unsigned char>(alias[end])) || ('*' == alias[end])))
+        {
+            ++end;
+        }
+        values[field] = alias.substr(pos, end - pos);
+        pos = end;
+    }
+
+    // Vendor and device ids are 8 digits wide, the 4 leading zeros are dropped
+    for (int field : {0, 1})
+    {
+        if (0 == values[field].compare(0, 4, "0000"))
+        {
+            values[field].erase(0, 4);
+        }
+    }
+
+    ids.vendorIDs.add(values[0]);
+    ids.deviceIDs.add(values[1]);
+    ids.classIDs.add(values[4] + values[5]);
+    return true;
+}
+
+void ModaliasIndex::writeList(std::ostream& out, const char* key,
+        const std::vector<std::string>& values)
+{
+    out << key << "=\"";
+    for (auto&& value = values.begin(); value != values.end(); ++value)
+    {
+        if (value != values.begin())
+        {
+            out << ' ';
+        }
+        out << *value;
+    }
+    out << "\"\n";
+}
@@ -0,0 +1,91 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MODALIASINDEX_HPP_
+#define MODALIASINDEX_HPP_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * PCI ids of every kernel module, read in one pass from modules.alias and
+ * modules.builtin.alias next to it. Replaces running modinfo and sed once
+ * per module (scripts/mhwd-modalias).
+ */
+class ModaliasIndex
+{
+public:
+    // The ids of one module, in the order modules.alias lists them
+    struct IDs
+    {
+        std::string module;
+        std::vector<std::string> classIDs;
+        std::vector<std::string> vendorIDs;
+        std::vector<std::string> deviceIDs;
+    };
+
+    explicit ModaliasIndex(const std::string& aliasFile);
+
+    static std::string defaultAliasFile();
+
+    // Modules are given by name or by the path of their file
+    bool contains(const std::string& module) const;
+    // Empty for modules without pci aliases
+    IDs ids(const std::string& module) const;
+
+    // The CLASSIDS, VENDORIDS and DEVICEIDS lines MHWDCONFIG uses, headed
+    // by "# <module>" when there is more than one module
+    static void write(std::ostream& out, const std::vector<IDs>& modules);
+
+private:
+    struct IDList
+    {
+        std::vector<std::string> values;
+        std::unordered_set<std::string> seen;
+
+        void add(const std::string& value);
+    };
+
+    struct ModuleIDs
+    {
+        IDList classIDs;
+        IDList vendorIDs;
+        IDList deviceIDs;
+    };
+
+    void read(std::istream& file);
+    static std::string normalizeName(const std::string& module);
+    bool parsePCIAlias(const std::string& alias, ModuleIDs& ids) const;
+    static void writeList(std::ostream& out, const char* key,
+            const std::vector<std::string>& values);
+
+    std::unordered_map<std::string, ModuleIDs> modules_;
+};
+
+#endif /* MODALIASINDEX_HPP_ */
@@ -0,0 +1,272 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "PackagePlanner.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "const.h"
+#include "vita/string.hpp"
+
+namespace
+{
+    const char* const MHWD_LIB32_CONFIG = "/etc/mhwd-x86_64.conf";
+
+    // "linux54", "linux515": what the script matches with ^linux[0-9][0-9]?([0-9])$
+    bool isKernelPackage(const std::string& package)
+    {
+        const std::string prefix{"linux"};
+        if ((package.compare(0, prefix.size(), prefix) != 0)
+                || (package.size() < prefix.size() + 2) || (package.size() > prefix.size() + 3))
+        {
+            return false;
+        }
+        for (std::size_t i = prefix.size(); i < package.size(); ++i)
+        {
+            if (!std::isdigit(static_cast<unsigned char>(package[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+PackagePlanner::PackagePlanner(const std::string& rootPath, const std::string& PMRootPath)
+{
+    struct utsname name;
+    if (0 == uname(&name))
+    {
+        arch_ = name.machine;
+    }
+
+    // The script sources the config of the root it installs into
+    std::ifstream lib32Config(("/" == rootPath) ? std::string{MHWD_LIB32_CONFIG}
+            : rootPath + MHWD_LIB32_CONFIG);
+    Vita::string line;
+    while (std::getline(lib32Config, line))
+    {
+        std::vector<Vita::string> parts = line.explode("=");
+        if ((parts.size() == 2) && ("MHWD64_IS_LIB32" == parts.front().trim()))
+        {
+            lib32_ = ("true" == parts.back().trim().trim("\""));
+        }
+    }
+
+    installedPackages_ = readLocalDatabase(PMRootPath);
+    for (const auto& package : installedPackages_)
+    {
+        if (isKernelPackage(package))
+        {
+            kernels_.push_back(package);
+        }
+    }
+    std::sort(kernels_.begin(), kernels_.end());
+}
+
+std::vector<std::string> PackagePlanner::removedPackages(const Config& config,
+        MHWD::TRANSACTIONTYPE type) const
+{
+    const Config::Packages& packages = config.packages_;
+    std::vector<std::string> removed;
+
+    if (MHWD::TRANSACTIONTYPE::INSTALL == type)
+    {
+        removed = packages.conflictsNoDeps;
+        if (("x86_64" == arch_) && lib32_)
+        {
+            removed.insert(removed.end(), packages.conflictsNoDeps64.begin(),
+                    packages.conflictsNoDeps64.end());
+        }
+        removed.insert(removed.end(), packages.conflicts.begin(), packages.conflicts.end());
+        appendArchPackages(removed, packages.conflicts32, packages.conflicts64);
+        appendKernelModules(removed, packages.conflictKernelModules);
+    }
+    else
+    {
+        removed = packages.depends;
+        appendArchPackages(removed, packages.depends32, packages.depends64);
+        appendKernelModules(removed, packages.dependKernelModules);
+    }
+
+    // The script only removes what is installed
+    return onlyInstalled(removed);
+}
+
+std::vector<std::string> PackagePlanner::installedPackages(const Config& config,
+        MHWD::TRANSACTIONTYPE type) const
+{
+    std::vector<std::string> installed;
+
+    if (MHWD::TRANSACTIONTYPE::INSTALL == type)
+    {
+        const Config::Packages& packages = config.packages_;
+        installed = packages.depends;
+        appendArchPackages(installed, packages.depends32, packages.depends64);
+        appendKernelModules(installed, packages.dependKernelModules);
+    }
+
+    return installed;
+}
+
+bool PackagePlanner::isInstalled(const std::string& package) const
+{
+    return installedPackages_.find(package) != installedPackages_.end();
+}
+
+void PackagePlanner::appendArchPackages(std::vector<std::string>& packages,
+        const std::vector<std::string>& packages32,
+        const std::vector<std::string>& packages64) const
+{
+    if ("i686" == arch_)
+    {
+        packages.insert(packages.end(), packages32.begin(), packages32.end());
+    }
+    else if (("x86_64" == arch_) && lib32_)
+    {
+        packages.insert(packages.end(), packages64.begin(), packages64.end());
+    }
+}
+
+void PackagePlanner::appendKernelModules(std::vector<std::string>& packages,
+        const std::vector<std::string>& modules) const
+{
+    for (const auto& kernel : kernels_)
+    {
+        for (const auto& module : modules)
+        {
+            packages.push_back(kernel + "-" + module);
+        }
+    }
+}
+
+std::vector<std::string> PackagePlanner::onlyInstalled(const std::vector<std::string>& packages) const
+{
+    std::vector<std::string> installed;
+    for (const auto& package : packages)
+    {
+        if (isInstalled(package))
+        {
+            installed.push_back(package);
+        }
+    }
+    return installed;
+}
+
+std::unordered_set<std::string> PackagePlanner::readLocalDatabase(const std::string& PMRootPath)
+{
+    std::unordered_set<std::string> packages;
+
+    // Entries of the local database are named <package>-<version>-<release>
+    const std::string localDatabase = PMRootPath + "/var/lib/pacman/local";
+    DIR *dir = opendir(localDatabase.c_str());
+    if (nullptr != dir)
+    {
+        struct dirent *entry;
+        while (nullptr != (entry = readdir(dir)))
+        {
+            std::string package{entry->d_name};
+            for (int i = 0; i < 2; ++i)
+            {
+                const std::size_t pos = package.find_last_of('-');
+                package.erase(std::string::npos == pos ? 0 : pos);
+            }
+            if (!package.empty())
+            {
+                packages.insert(package);
+            }
+        }
+        closedir(dir);
+    }
+
+    return packages;
+}
+
+long PackagePlanner::syncDatabaseAge(const std::string& PMRootPath)
+{
+    // pacman sets the mtime of a database to the mirror's Last-Modified and leaves
+    // it alone when the mirror has nothing new, so neither tells when we last synced
+    bool found = false;
+    time_t synced = 0;
+
+    struct stat fileStat;
+    if (0 == stat((PMRootPath + MHWD_PM_SYNC_STAMP).c_str(), &fileStat))
+    {
+        synced = fileStat.st_mtime;
+        found = true;
+    }
+
+    // Syncs done by pacman itself: ctime is when the database was written here
+    const std::string syncDatabase = PMRootPath + "/var/lib/pacman/sync";
+    DIR *dir = opendir(syncDatabase.c_str());
+    if (nullptr != dir)
+    {
+        bool foundDatabase = false;
+        time_t oldest = 0;
+        struct dirent *entry;
+        while (nullptr != (entry = readdir(dir)))
+        {
+            const std::string name{entry->d_name};
+            if ((name.size() <= 3) || (name.compare(name.size() - 3, 3, ".db") != 0))
+            {
+                continue;
+            }
+
+            if (0 == stat((syncDatabase + "/" + name).c_str(), &fileStat))
+            {
+                if (!foundDatabase || (fileStat.st_ctime < oldest))
+                {
+                    oldest = fileStat.st_ctime;
+                }
+                foundDatabase = true;
+            }
+        }
+        closedir(dir);
+
+        if (foundDatabase && (!found || (oldest > synced)))
+        {
+            synced = oldest;
+            found = true;
+        }
+    }
+
+    return found ? static_cast<long>(std::difftime(std::time(nullptr), synced)) : -1;
+}
+
+bool PackagePlanner::recordSync(const std::string& PMRootPath)
+{
+    std::ofstream stamp(PMRootPath + MHWD_PM_SYNC_STAMP, std::ios::trunc);
+    return static_cast<bool>(stamp << "# mhwd synced the package databases\n");
+}
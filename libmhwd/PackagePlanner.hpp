@@ -0,0 +1,73 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PACKAGEPLANNER_HPP_
+#define PACKAGEPLANNER_HPP_
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Config.hpp"
+#include "Enums.hpp"
+
+/*
+ * Works out which packages the mhwd script will remove and install for a
+ * config, the same way the script does, but from the local pacman
+ * database directory instead of running pacman.
+ */
+class PackagePlanner
+{
+public:
+    PackagePlanner(const std::string& rootPath, const std::string& PMRootPath);
+
+    std::vector<std::string> removedPackages(const Config& config,
+            MHWD::TRANSACTIONTYPE type) const;
+    std::vector<std::string> installedPackages(const Config& config,
+            MHWD::TRANSACTIONTYPE type) const;
+    bool isInstalled(const std::string& package) const;
+
+    // Names of all packages in the local database below PMRootPath
+    static std::unordered_set<std::string> readLocalDatabase(const std::string& PMRootPath);
+    // Seconds since mhwd or pacman last synced the package databases, -1 if never
+    static long syncDatabaseAge(const std::string& PMRootPath);
+    // Called after each successful sync, for syncDatabaseAge
+    static bool recordSync(const std::string& PMRootPath);
+
+private:
+    void appendArchPackages(std::vector<std::string>& packages,
+            const std::vector<std::string>& packages32,
+            const std::vector<std::string>& packages64) const;
+    void appendKernelModules(std::vector<std::string>& packages,
+            const std::vector<std::string>& modules) const;
+    std::vector<std::string> onlyInstalled(const std::vector<std::string>& packages) const;
+
+    std::string arch_;
+    bool lib32_ = true;
+    std::unordered_set<std::string> installedPackages_;
+    std::vector<std::string> kernels_;
+};
+
+#endif /* PACKAGEPLANNER_HPP_ */
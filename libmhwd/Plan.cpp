@@ -0,0 +1,160 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Plan.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vita/string.hpp"
+
+namespace
+{
+    std::string join(const std::vector<std::string>& values)
+    {
+        std::string joined;
+        for (const auto& value : values)
+        {
+            joined += (joined.empty() ? "" : " ") + value;
+        }
+        return joined;
+    }
+
+    std::vector<std::string> split(Vita::string value)
+    {
+        std::vector<std::string> values;
+        for (auto&& part : value.trim().explode(" "))
+        {
+            if (!part.empty())
+            {
+                values.push_back(part);
+            }
+        }
+        return values;
+    }
+}
+
+bool Plan::contains(const std::string& configName, MHWD::BUS configType,
+        MHWD::TRANSACTIONTYPE type) const
+{
+    for (const auto& step : steps)
+    {
+        if ((step.type == type) && (step.config->name_ == configName)
+                && (step.config->type_ == configType))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::shared_ptr<Config>> Plan::getDependencies() const
+{
+    std::vector<std::shared_ptr<Config>> dependencies;
+    for (const auto& step : steps)
+    {
+        if (step.dependency)
+        {
+            dependencies.push_back(step.config);
+        }
+    }
+    return dependencies;
+}
+
+void Plan::write(std::ostream& out) const
+{
+    out << "# ACTION|BUS|NAME|VERSION|ROLE|CONFIGPATH|REMOVEDPACKAGES|INSTALLEDPACKAGES\n";
+    if (!root.empty())
+    {
+        out << "root|" << root << '\n';
+    }
+    out << "sync|" << (sync ? "yes" : "no") << '\n';
+    for (const auto& step : steps)
+    {
+        out << (MHWD::TRANSACTIONTYPE::INSTALL == step.type ? "install" : "remove") << '|'
+                << MHWD::busName(step.config->type_) << '|'
+                << step.config->name_ << '|'
+                << step.config->version_ << '|'
+                << (step.dependency ? "dependency" : "config") << '|'
+                << step.config->configPath_ << '|'
+                << join(step.removedPackages) << '|'
+                << join(step.installedPackages) << '\n';
+    }
+    out.flush();
+}
+
+std::vector<Plan> Plan::read(std::istream& in)
+{
+    std::vector<Plan> plans;
+    Vita::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        line = line.trim();
+        if (line.empty() || ('#' == line[0]))
+        {
+            continue;
+        }
+
+        std::vector<Vita::string> fields = line.explode("|");
+        MHWD::BUS bus;
+        if ((2 == fields.size()) && ("root" == fields[0]))
+        {
+            plans.emplace_back();
+            plans.back().root = fields[1];
+            continue;
+        }
+        else if (plans.empty())
+        {
+            // Plans without --root have no root line
+            plans.emplace_back();
+        }
+
+        Plan& plan = plans.back();
+        if ((2 == fields.size()) && ("sync" == fields[0]))
+        {
+            plan.sync = ("yes" == fields[1]);
+            continue;
+        }
+        else if ((8 != fields.size()) || (("install" != fields[0]) && ("remove" != fields[0]))
+                || !MHWD::parseBus(fields[1], bus))
+        {
+            throw std::runtime_error{"invalid plan line " + std::to_string(lineNumber)};
+        }
+
+        std::shared_ptr<Config> config{new Config(fields[5], bus)};
+        config->name_ = fields[2];
+        config->version_ = fields[3];
+
+        plan.steps.push_back({"install" == fields[0] ? MHWD::TRANSACTIONTYPE::INSTALL
+                : MHWD::TRANSACTIONTYPE::REMOVE, config, "dependency" == fields[4],
+                split(fields[6]), split(fields[7])});
+    }
+
+    return plans;
+}
@@ -0,0 +1,79 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PLAN_HPP_
+#define PLAN_HPP_
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Enums.hpp"
+
+/*
+ * Everything a transaction will do, resolved up front: the configs in
+ * the order they are removed and installed, the packages the script
+ * touches for each, and whether the package database gets synced.
+ *
+ * Plans are stored one step per line, fields separated by '|':
+ *
+ *   root|<path>
+ *   sync|<yes/no>
+ *   ACTION|BUS|NAME|VERSION|ROLE|CONFIGPATH|REMOVEDPACKAGES|INSTALLEDPACKAGES
+ *
+ * ACTION is install or remove, ROLE is config or dependency, package
+ * lists are separated by spaces. Lines starting with '#' are ignored.
+ * The root line is only written for plans made with --root; each one
+ * starts the plan of that root, so one file holds the plans of all roots.
+ */
+struct Plan
+{
+    struct Step
+    {
+        MHWD::TRANSACTIONTYPE type;
+        std::shared_ptr<Config> config;
+        bool dependency;
+        std::vector<std::string> removedPackages;
+        std::vector<std::string> installedPackages;
+    };
+
+    bool contains(const std::string& configName, MHWD::BUS configType,
+            MHWD::TRANSACTIONTYPE type) const;
+    std::vector<std::shared_ptr<Config>> getDependencies() const;
+
+    void write(std::ostream& out) const;
+    // Every plan in the stream, in the order they were written
+    static std::vector<Plan> read(std::istream& in);
+
+    std::vector<Step> steps;
+    bool sync = false;
+    // Empty unless planned for a --root
+    std::string root;
+};
+
+#endif /* PLAN_HPP_ */
@@ -0,0 +1,173 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Planner.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "PackagePlanner.hpp"
+#include "Profiler.hpp"
+#include "Transaction.hpp"
+
+Planner::Planner(const Data& data, bool allowReinstallation)
+    : data_(data), allowReinstallation_(allowReinstallation)
+{}
+
+MHWD::STATUS Planner::plan(const std::vector<std::shared_ptr<Config>>& configs,
+        MHWD::TRANSACTIONTYPE transactionType, Plan& plan)
+{
+    Profiler::ScopedTimer timer("Planner::plan");
+    PackagePlanner packagePlanner{data_.environment.rootPath, data_.environment.PMRootPath};
+
+    auto addStep = [&plan, &packagePlanner](MHWD::TRANSACTIONTYPE type,
+            std::shared_ptr<Config> config, bool dependency) {
+        plan.steps.push_back({type, config, dependency,
+                packagePlanner.removedPackages(*config, type),
+                packagePlanner.installedPackages(*config, type)});
+    };
+
+    for (const auto& config : configs)
+    {
+        Transaction transaction (data_, config, transactionType, allowReinstallation_);
+        std::shared_ptr<Config> installedConfig{data_.getInstalledConfig(config->name_, config->type_)};
+        failedConfig_ = config;
+
+        if (MHWD::TRANSACTIONTYPE::INSTALL == transactionType)
+        {
+            if (!transaction.conflictedConfigs_.empty())
+            {
+                blockingConfigs_ = transaction.conflictedConfigs_;
+                return MHWD::STATUS::ERROR_CONFLICTS;
+            }
+
+            // Already pulled in as dependency of an earlier config
+            if (plan.contains(config->name_, config->type_, MHWD::TRANSACTIONTYPE::INSTALL))
+            {
+                continue;
+            }
+
+            // Installed configs were checked above, configs of this run are only in the plan
+            std::vector<std::shared_ptr<Config>> newConfigs{config};
+            for (const auto& dependencyConfig : transaction.dependencyConfigs_)
+            {
+                if (!plan.contains(dependencyConfig->name_, dependencyConfig->type_,
+                        MHWD::TRANSACTIONTYPE::INSTALL))
+                {
+                    newConfigs.push_back(dependencyConfig);
+                }
+            }
+            blockingConfigs_ = plannedConflicts(plan, newConfigs);
+            if (!blockingConfigs_.empty())
+            {
+                return MHWD::STATUS::ERROR_CONFLICTS;
+            }
+
+            if (nullptr != installedConfig)
+            {
+                if (!transaction.isAllowedToReinstall())
+                {
+                    return MHWD::STATUS::ERROR_ALREADY_INSTALLED;
+                }
+                addStep(MHWD::TRANSACTIONTYPE::REMOVE, installedConfig, false);
+            }
+
+            // Dependencies first, deepest first
+            for (auto&& dependencyConfig = transaction.dependencyConfigs_.rbegin();
+                    dependencyConfig != transaction.dependencyConfigs_.rend(); ++dependencyConfig)
+            {
+                if (!plan.contains((*dependencyConfig)->name_, (*dependencyConfig)->type_,
+                        MHWD::TRANSACTIONTYPE::INSTALL))
+                {
+                    addStep(MHWD::TRANSACTIONTYPE::INSTALL, *dependencyConfig, true);
+                }
+            }
+            addStep(MHWD::TRANSACTIONTYPE::INSTALL, config, false);
+        }
+        else if (MHWD::TRANSACTIONTYPE::REMOVE == transactionType)
+        {
+            if (!transaction.configsRequirements_.empty())
+            {
+                blockingConfigs_ = transaction.configsRequirements_;
+                return MHWD::STATUS::ERROR_REQUIREMENTS;
+            }
+            else if (nullptr == installedConfig)
+            {
+                return MHWD::STATUS::ERROR_NOT_INSTALLED;
+            }
+            else if (!plan.contains(config->name_, config->type_, MHWD::TRANSACTIONTYPE::REMOVE))
+            {
+                addStep(MHWD::TRANSACTIONTYPE::REMOVE, installedConfig, false);
+            }
+        }
+    }
+    failedConfig_.reset();
+
+    // The script syncs once, with the first packages it installs
+    for (const auto& step : plan.steps)
+    {
+        if ((MHWD::TRANSACTIONTYPE::INSTALL == step.type) && !step.installedPackages.empty())
+        {
+            plan.sync = data_.environment.syncPackageManagerDatabase;
+            break;
+        }
+    }
+
+    return MHWD::STATUS::SUCCESS;
+}
+
+std::vector<std::shared_ptr<Config>> Planner::plannedConflicts(const Plan& plan,
+        const std::vector<std::shared_ptr<Config>>& configs)
+{
+    std::vector<std::shared_ptr<Config>> conflicts;
+    for (const auto& step : plan.steps)
+    {
+        if (MHWD::TRANSACTIONTYPE::INSTALL != step.type)
+        {
+            continue;
+        }
+
+        for (const auto& config : configs)
+        {
+            if (config->type_ != step.config->type_)
+            {
+                continue;
+            }
+
+            // Either side may declare the conflict
+            const bool conflicting = (std::find(config->conflicts_.begin(), config->conflicts_.end(),
+                    step.config->name_) != config->conflicts_.end())
+                    || (std::find(step.config->conflicts_.begin(), step.config->conflicts_.end(),
+                    config->name_) != step.config->conflicts_.end());
+            if (conflicting && (std::find(conflicts.begin(), conflicts.end(), step.config)
+                    == conflicts.end()))
+            {
+                conflicts.push_back(step.config);
+            }
+        }
+    }
+    return conflicts;
+}
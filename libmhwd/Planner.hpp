@@ -0,0 +1,62 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PLANNER_HPP_
+#define PLANNER_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "Config.hpp"
+#include "Data.hpp"
+#include "Enums.hpp"
+#include "Plan.hpp"
+
+/*
+ * Resolves the transactions for a set of configs into one Plan, without
+ * touching the system. On failure failedConfig_ names the config that
+ * could not be planned and blockingConfigs_ the configs in its way.
+ */
+class Planner
+{
+public:
+    Planner(const Data& data, bool allowReinstallation);
+
+    MHWD::STATUS plan(const std::vector<std::shared_ptr<Config>>& configs,
+            MHWD::TRANSACTIONTYPE type, Plan& plan);
+
+    std::shared_ptr<Config> failedConfig_;
+    std::vector<std::shared_ptr<Config>> blockingConfigs_;
+
+private:
+    // INSTALL steps of the plan that conflict with one of configs
+    static std::vector<std::shared_ptr<Config>> plannedConflicts(const Plan& plan,
+            const std::vector<std::shared_ptr<Config>>& configs);
+
+    const Data& data_;
+    bool allowReinstallation_;
+};
+
+#endif /* PLANNER_HPP_ */
@@ -0,0 +1,97 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+Profiler::ScopedTimer::ScopedTimer(const std::string& phase)
+    : phase_(phase), start_(std::chrono::steady_clock::now())
+{}
+
+Profiler::ScopedTimer::~ScopedTimer()
+{
+    Profiler::instance().addTime(phase_, std::chrono::steady_clock::now() - start_);
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+const char* Profiler::counterName(COUNTER counter)
+{
+    switch (counter)
+    {
+        case COUNTER::FILES_READ:
+            return "files_read";
+        case COUNTER::CONFIGS_PARSED:
+            return "configs_parsed";
+        case COUNTER::MATCH_COMPARISONS:
+            return "match_comparisons";
+        case COUNTER::CHILD_PROCESSES:
+            return "child_processes";
+        default:
+            return "unknown";
+    }
+}
+
+void Profiler::addTime(const std::string& phase, std::chrono::steady_clock::duration duration)
+{
+    const double milliseconds = std::chrono::duration<double, std::milli>(duration).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto found = std::find_if(phases_.begin(), phases_.end(), [&phase](const Phase& p) {
+                return p.name == phase;
+            });
+    if (found != phases_.end())
+    {
+        ++found->calls;
+        found->milliseconds += milliseconds;
+    }
+    else
+    {
+        phases_.push_back({phase, 1, milliseconds});
+    }
+}
+
+void Profiler::count(COUNTER counter, unsigned long amount)
+{
+    counters_[static_cast<int>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+unsigned long Profiler::counter(COUNTER counter) const
+{
+    return counters_[static_cast<int>(counter)].load(std::memory_order_relaxed);
+}
+
+std::vector<Profiler::Phase> Profiler::phases() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+}
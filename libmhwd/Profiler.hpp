@@ -0,0 +1,87 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Process wide phase timings and counters. Collection is always on and
+ * cheap; mhwd only prints the summary when --profile is given.
+ */
+class Profiler
+{
+public:
+    enum class COUNTER
+    {
+        FILES_READ,
+        CONFIGS_PARSED,
+        MATCH_COMPARISONS,
+        CHILD_PROCESSES,
+        COUNT
+    };
+
+    struct Phase
+    {
+        std::string name;
+        unsigned long calls;
+        double milliseconds;
+    };
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const std::string& phase);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        std::string phase_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    static Profiler& instance();
+    static const char* counterName(COUNTER counter);
+
+    void addTime(const std::string& phase, std::chrono::steady_clock::duration duration);
+    void count(COUNTER counter, unsigned long amount = 1);
+    unsigned long counter(COUNTER counter) const;
+    std::vector<Phase> phases() const;
+
+private:
+    Profiler() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Phase> phases_;
+    std::atomic<unsigned long> counters_[static_cast<int>(COUNTER::COUNT)] {};
+};
+
+#endif /* PROFILER_HPP_ */
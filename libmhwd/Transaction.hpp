@@ -35,7 +35,7 @@ class Transaction
 {
 public:
     Transaction() = delete;
-    Transaction(Data data, std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE type,
+    Transaction(const Data& data, std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE type,
             bool allowReinstallation);
 
     bool isAllowedToReinstall() const;
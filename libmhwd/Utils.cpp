@@ -0,0 +1,132 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *  Oscar Forner Martinez <oscar.forner.martinez@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Utils.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace MhwdUtils
+{
+
+hash_t hash(char const* str)
+{
+	hash_t ret{basis};
+ 
+	while(*str){
+		ret ^= *str;
+		ret *= prime;
+		str++;
+	}
+ 
+	return ret;
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& content)
+{
+    // Replace the file a symlink points to, not the symlink
+    std::string target{path};
+    char resolved[PATH_MAX];
+    if (nullptr != realpath(path.c_str(), resolved))
+    {
+        target = resolved;
+    }
+
+    const std::string tmpPath{target + ".tmp"};
+    const int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // The new file takes the old one's place, with its owner and mode. Only
+    // root can give a file away, anyone else keeps owning what they write.
+    bool written = true;
+    struct stat old;
+    if (0 == stat(target.c_str(), &old))
+    {
+        written = ((0 == fchown(fd, old.st_uid, old.st_gid)) || (EPERM == errno))
+                && (0 == fchmod(fd, old.st_mode & 07777));
+    }
+
+    std::size_t offset = 0;
+    while (written && (offset < content.size()))
+    {
+        const ssize_t size = write(fd, content.data() + offset, content.size() - offset);
+        if (size >= 0)
+        {
+            offset += size;
+        }
+        else if (EINTR != errno)
+        {
+            written = false;
+        }
+    }
+
+    // Without the sync, a crash after the rename can leave an empty file behind
+    written = written && (0 == fsync(fd));
+    written = (0 == close(fd)) && written;
+    if (!written || (0 != std::rename(tmpPath.c_str(), target.c_str())))
+    {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> listDirectory(const std::string& directory)
+{
+    std::vector<std::string> entries;
+    DIR *dir = opendir(directory.c_str());
+    if (nullptr == dir)
+    {
+        return entries;
+    }
+
+    struct dirent *entry;
+    while (nullptr != (entry = readdir(dir)))
+    {
+        const std::string name{entry->d_name};
+        if (("." != name) && (".." != name))
+        {
+            entries.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end());
+    return entries;
+}
+
+}; // End namespace
@@ -28,6 +28,7 @@
 
 #include <string>
 #include <cstdint>
+#include <vector>
 
 namespace MhwdUtils
 {
@@ -42,19 +43,16 @@ constexpr hash_t hash_compile_time(char const* str, hash_t last_value = basis)
 {
 	return *str ? hash_compile_time(str+1, (*str ^ last_value) * prime) : last_value;
 }
- 
-hash_t hash(char const* str)
-{
-	hash_t ret{basis};
- 
-	while(*str){
-		ret ^= *str;
-		ret *= prime;
-		str++;
-	}
- 
-	return ret;
-}
+
+hash_t hash(char const* str);
+
+// Writes path.tmp, syncs it to disk and renames it over path, so readers
+// and crashes never see half a file. A symlink at path is followed, and an
+// existing file keeps its owner and mode.
+bool writeFileAtomically(const std::string& path, const std::string& content);
+
+// Sorted entry names of directory without "." and "..", empty if it can't be read
+std::vector<std::string> listDirectory(const std::string& directory);
 
 }; // End namespace
 
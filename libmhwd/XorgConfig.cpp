@@ -0,0 +1,122 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "XorgConfig.hpp"
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Utils.hpp"
+#include "vita/string.hpp"
+
+XorgConfig::XorgConfig(const std::string& path)
+    : path_(path)
+{
+    std::ifstream file(path_);
+    if (file)
+    {
+        std::ostringstream content;
+        content << file.rdbuf();
+        content_ = content.str();
+    }
+}
+
+unsigned int XorgConfig::addDeviceSections(const std::string& driver,
+        const std::vector<std::shared_ptr<Device>>& devices, const std::string& vendorID,
+        const std::string& lines, const std::string& screenLines, unsigned int firstIdentifier)
+{
+    unsigned int identifier = firstIdentifier;
+
+    if (!vendorID.empty())
+    {
+        for (const auto& device : devices)
+        {
+            if (("0300" == device->classID_) && (("*" == vendorID) || (vendorID == device->vendorID_)))
+            {
+                addDeviceSection(driver, device->sysfsBusID_, lines, screenLines, identifier++);
+            }
+        }
+    }
+
+    if (identifier == firstIdentifier)
+    {
+        addDeviceSection(driver, "", lines, screenLines, identifier++);
+    }
+
+    return identifier - firstIdentifier;
+}
+
+bool XorgConfig::write() const
+{
+    // X never reads half a config
+    return MhwdUtils::writeFileAtomically(path_, content_);
+}
+
+void XorgConfig::addDeviceSection(const std::string& driver, const std::string& busID,
+        const std::string& lines, const std::string& screenLines, unsigned int identifier)
+{
+    const std::string number{std::to_string(identifier)};
+
+    content_ += "Section \"Device\"\n";
+    content_ += "    Identifier  \"Device" + number + "\"\n";
+    content_ += "    Driver      \"" + driver + "\"\n";
+    if (!busID.empty())
+    {
+        content_ += "    BusID       \"PCI:" + busID + "\"\n";
+    }
+    addLines(lines);
+    content_ += "EndSection\n \n";
+
+    if (!screenLines.empty())
+    {
+        content_ += "Section \"Screen\"\n";
+        content_ += "    Identifier  \"Screen" + number + "\"\n";
+        content_ += "    Device      \"Device" + number + "\"\n";
+        addLines(screenLines);
+        content_ += "EndSection\n \n";
+    }
+}
+
+void XorgConfig::addLines(const std::string& lines)
+{
+    if (lines.empty())
+    {
+        return;
+    }
+
+    // Like bash word splitting on IFS='|': a trailing separator adds no line
+    std::vector<Vita::string> fields{Vita::string(lines).explode("|")};
+    if (fields.back().empty())
+    {
+        fields.pop_back();
+    }
+    for (const auto& field : fields)
+    {
+        content_ += "    " + field + "\n";
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XORGCONFIG_HPP_
+#define XORGCONFIG_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Device.hpp"
+
+/*
+ * Adds Device (and Screen) sections to an xorg config for the devices mhwd
+ * passed to a config script, in place of the echo >> appends of
+ * scripts/include/0300. The file is read once, the sections are built in
+ * memory and write() replaces the file with a single rename.
+ */
+class XorgConfig
+{
+public:
+    explicit XorgConfig(const std::string& path);
+
+    // One Device section per display controller (class 0300) of vendorID,
+    // "*" for any vendor, or a single one without BusID when vendorID is
+    // empty or no device matches. Device bus ids are in the form given to
+    // the scripts ("1:0:0"). Lines are '|' separated like the argument of
+    // MHWD_ADD_DEVICE_SECTION; with screenLines each Device section is
+    // followed by a Screen section using it. Sections are numbered from
+    // firstIdentifier, the number of Device sections added is returned.
+    unsigned int addDeviceSections(const std::string& driver,
+            const std::vector<std::shared_ptr<Device>>& devices, const std::string& vendorID,
+            const std::string& lines, const std::string& screenLines, unsigned int firstIdentifier);
+    bool write() const;
+
+private:
+    void addDeviceSection(const std::string& driver, const std::string& busID,
+            const std::string& lines, const std::string& screenLines, unsigned int identifier);
+    void addLines(const std::string& lines);
+
+    std::string path_;
+    std::string content_;
+};
+
+#endif /* XORGCONFIG_HPP_ */
@@ -25,7 +25,23 @@
 #define MHWD_USB_DATABASE_DIR "/var/lib/mhwd/local/usb"
 #define MHWD_PCI_DATABASE_DIR  "/var/lib/mhwd/local/pci"
 #define MHWD_SCRIPT_PATH "/var/lib/mhwd/scripts/mhwd"
+#define MHWD_AUTOCONFIGURE_STATE "/var/lib/mhwd/local/autoconfigure"
+#define MHWD_METRICS_STORE "/var/lib/mhwd/local/metrics"
+// Samples the metrics store keeps, about 100 bytes each
+#define MHWD_METRICS_MAX_SAMPLES 2000
+#define MHWD_LOG_DIR "/var/log/mhwd"
+// Transaction logs kept in MHWD_LOG_DIR, older ones are removed
+#define MHWD_LOG_MAX_FILES 20
+
+#define MHWD_XORG_CONFIG "/etc/X11/xorg.conf.d/90-mhwd.conf"
+#define MHWD_GPU_MODPROBE_CONFIG "/etc/modprobe.d/mhwd-gpu.conf"
+#define MHWD_GPU_MODULES_LOAD "/etc/modules-load.d/mhwd-gpu.conf"
+#define MHWD_MODPROBE_DIR "/etc/modprobe.d"
 
 #define MHWD_PM_CACHE_DIR "/var/cache/pacman/pkg"
 #define MHWD_PM_CONFIG "/etc/pacman.conf"
 #define MHWD_PM_ROOT "/"
+// Seconds a package database sync stays fresh enough to skip another one
+#define MHWD_PM_SYNC_MAX_AGE 3600
+// Touched below the pacman root after mhwd synced the package databases
+#define MHWD_PM_SYNC_STAMP "/var/lib/mhwd/local/pacman-sync"
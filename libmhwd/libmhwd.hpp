@@ -0,0 +1,67 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LIBMHWD_HPP_
+#define LIBMHWD_HPP_
+
+/*
+ * Public interface of libmhwd, for programs that want to match hardware
+ * and plan transactions in-process instead of running the mhwd command.
+ *
+ * A Data built once holds the probed devices and the parsed database and
+ * can be queried as long as it lives; updateInstalledConfigData() picks
+ * up changes made by others. Put it into a DataStore to share it between
+ * threads: readers take snapshots, writers publish new versions. Planner
+ * resolves install and remove requests into a Plan without touching the
+ * system. Fleet runs the auto selection for many recorded machines.
+ *
+ * MHWD_API_VERSION is raised whenever these headers change incompatibly.
+ */
+#define MHWD_API_VERSION 2
+
+#include "AutoConfigure.hpp"
+#include "AutoConfigureState.hpp"
+#include "Config.hpp"
+#include "const.h"
+#include "Data.hpp"
+#include "DataStore.hpp"
+#include "Device.hpp"
+#include "DeviceSource.hpp"
+#include "Enums.hpp"
+#include "FixtureDeviceSource.hpp"
+#include "Fleet.hpp"
+#include "GpuStatus.hpp"
+#include "HardwareDeviceSource.hpp"
+#include "InternedString.hpp"
+#include "KernelPlanner.hpp"
+#include "MetricsStore.hpp"
+#include "ModaliasIndex.hpp"
+#include "Plan.hpp"
+#include "Planner.hpp"
+#include "Profiler.hpp"
+#include "Transaction.hpp"
+#include "XorgConfig.hpp"
+
+#endif /* LIBMHWD_HPP_ */
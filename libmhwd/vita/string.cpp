@@ -10,6 +10,8 @@
 
 #include <string.hpp>
 
+#include <algorithm>
+
 namespace Vita {
 
     string string::toLower() const {
@@ -97,4 +99,132 @@ namespace Vita {
         return result;
     }
 
+    size_t string::split(char delimiter, std::vector<stringview>& fields) const {
+        fields.clear();
+        size_t previous = 0, current;
+
+        current = this->find(delimiter);
+
+        while (current != npos) {
+            fields.push_back(stringview(this->data() + previous, current - previous));
+            previous = current + 1;
+            current = this->find(delimiter, previous);
+        }
+        fields.push_back(stringview(this->data() + previous, this->size() - previous));
+        return fields.size();
+    }
+
+    string& string::toLowerInPlace() {
+        for (size_t i = 0; i < this->length(); i++) {
+            (*this)[i] = tolower((*this)[i]);
+        }
+        return *this;
+    }
+
+    string& string::toUpperInPlace() {
+        for (size_t i = 0; i < this->length(); i++) {
+            (*this)[i] = toupper((*this)[i]);
+        }
+        return *this;
+    }
+
+    string& string::trimInPlace(const char* what) {
+        size_t pos = this->find_last_not_of(what);
+        this->erase(pos + 1);
+        pos = this->find_first_not_of(what);
+        this->erase(0, pos);
+        return *this;
+    }
+
+    void string::appendNumber(std::string& out, unsigned long value, int base, size_t width) {
+        char digits[sizeof(unsigned long) * 8];
+        size_t count = 0;
+
+        do {
+            digits[count++] = "0123456789abcdef"[value % base];
+            value /= base;
+        } while (value);
+
+        while (count < width) {
+            out += '0';
+            --width;
+        }
+        while (count) {
+            out += digits[--count];
+        }
+    }
+
+    stringview stringview::substr(size_t pos, size_t n) const {
+        if (pos > size_) {
+            pos = size_;
+        }
+        if (n > size_ - pos) {
+            n = size_ - pos;
+        }
+        return stringview(data_ + pos, n);
+    }
+
+    size_t stringview::find(char c, size_t pos) const {
+        for (size_t i = pos; i < size_; i++) {
+            if (data_[i] == c) {
+                return i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    size_t stringview::rfind(char c) const {
+        for (size_t i = size_; i > 0; i--) {
+            if (data_[i - 1] == c) {
+                return i - 1;
+            }
+        }
+        return std::string::npos;
+    }
+
+    stringview stringview::trim(const char* what) const {
+        const char* end = what + std::char_traits<char>::length(what);
+        size_t first = 0, last = size_;
+
+        while (first < last && std::find(what, end, data_[first]) != end) {
+            ++first;
+        }
+        while (last > first && std::find(what, end, data_[last - 1]) != end) {
+            --last;
+        }
+        return stringview(data_ + first, last - first);
+    }
+
+    bool stringview::operator==(stringview other) const {
+        return size_ == other.size_ && std::char_traits<char>::compare(data_, other.data_, size_) == 0;
+    }
+
+    bool stringview::toUnsigned(unsigned long& value, int base) const {
+        if (empty()) {
+            return false;
+        }
+
+        unsigned long result = 0;
+        for (size_t i = 0; i < size_; i++) {
+            const char c = data_[i];
+            unsigned long digit;
+            if (c >= '0' && c <= '9') {
+                digit = c - '0';
+            } else if (base == 16 && c >= 'a' && c <= 'f') {
+                digit = c - 'a' + 10;
+            } else if (base == 16 && c >= 'A' && c <= 'F') {
+                digit = c - 'A' + 10;
+            } else {
+                return false;
+            }
+            if (digit >= static_cast<unsigned long>(base)
+                    || result > (static_cast<unsigned long>(-1) - digit) / base) {
+                return false;
+            }
+            result = result * base + digit;
+        }
+        value = result;
+        return true;
+    }
+
 } // namespace Vita
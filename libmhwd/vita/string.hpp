@@ -18,6 +18,68 @@
 
 namespace Vita {
 
+    /**
+     * Non-owning view of a run of characters, a small stand-in for C++17's
+     * std::string_view. It stays valid only as long as the characters it
+     * points to are neither changed nor freed.
+     */
+    class stringview {
+        public:
+            stringview():data_(nullptr), size_(0) {};
+
+            stringview(const char* data, size_t size):data_(data), size_(size) {};
+
+            stringview(const char* cstr):data_(cstr), size_(std::char_traits<char>::length(cstr)) {};
+
+            stringview(const std::string& str):data_(str.data()), size_(str.size()) {};
+
+            const char* data() const { return data_; }
+            size_t size() const { return size_; }
+            bool empty() const { return 0 == size_; }
+            char operator[](size_t pos) const { return data_[pos]; }
+
+            /**
+             * Copy the viewed characters into a new std::string.
+             */
+            std::string str() const { return std::string(data_, size_); }
+
+            /**
+             * View of at most @a n characters starting at @a pos.
+             */
+            stringview substr(size_t pos, size_t n = std::string::npos) const;
+
+            /**
+             * Position of the first @a c at or after @a pos, std::string::npos if none.
+             */
+            size_t find(char c, size_t pos = 0) const;
+
+            /**
+             * Position of the last @a c, std::string::npos if none.
+             */
+            size_t rfind(char c) const;
+
+            /**
+             * Like string::trim(), but returns a view into the same characters.
+             */
+            stringview trim(const char* what = "\x9\xa\xd\x20") const;
+
+            bool operator==(stringview other) const;
+            bool operator!=(stringview other) const { return !(*this == other); }
+
+            /**
+             * Parse the whole view as an unsigned number, like C++17's std::from_chars.
+             *
+             * @param value Receives the number, untouched on failure.
+             * @param base 10 or 16; hex digits may be upper or lower case.
+             * @return false if the view is empty, has other characters or overflows.
+             */
+            bool toUnsigned(unsigned long& value, int base = 10) const;
+
+        private:
+            const char* data_;
+            size_t size_;
+    };
+
     /**
      * Slightly enhanced version of std::string.
      */
@@ -141,6 +203,45 @@ namespace Vita {
              */
             string trim(const string& what = "\x9\xa\xd\x20") const;
 
+            /**
+             * Split the string at each @a delimiter into views, without copying.
+             *
+             * Like explode(), empty fields are kept. The views point into this
+             * string and @a fields is cleared first, so one vector can be reused
+             * for every line of a file.
+             *
+             * @param delimiter The boundary character.
+             * @param fields Receives the fields.
+             * @return The number of fields.
+             */
+            size_t split(char delimiter, std::vector<stringview>& fields) const;
+
+            /**
+             * Convert all characters to lower case, in place.
+             */
+            string& toLowerInPlace();
+
+            /**
+             * Convert all characters to upper case, in place.
+             */
+            string& toUpperInPlace();
+
+            /**
+             * Trim unwanted characters from both ends, in place.
+             */
+            string& trimInPlace(const char* what = "\x9\xa\xd\x20");
+
+            /**
+             * Append a number to a string without going through a stream.
+             *
+             * @param out The string to append to.
+             * @param value The number.
+             * @param base 10 or 16 (lower case digits).
+             * @param width Pad with leading zeros to at least this many digits.
+             */
+            static void appendNumber(std::string& out, unsigned long value, int base = 10,
+                    size_t width = 0);
+
             /**
              * Convert a generic data type to string.
              *
@@ -0,0 +1,180 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ChildProcess.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+
+#include "Profiler.hpp"
+
+namespace
+{
+    // Longer lines are handed on in pieces of this size, a child without newlines can't grow memory
+    constexpr std::size_t MAX_LINE_LENGTH = 64 * 1024;
+
+    struct Pipe
+    {
+        int fd;
+        ChildProcess::STREAM stream;
+        std::string pending;
+    };
+
+    void passLines(Pipe& pipe, const ChildProcess::LineHandler& onLine, bool eof)
+    {
+        std::size_t begin = 0;
+        std::size_t end;
+        while (std::string::npos != (end = pipe.pending.find('\n', begin)))
+        {
+            onLine(pipe.stream, pipe.pending.substr(begin, end + 1 - begin));
+            begin = end + 1;
+        }
+        pipe.pending.erase(0, begin);
+
+        while (pipe.pending.size() >= MAX_LINE_LENGTH)
+        {
+            onLine(pipe.stream, pipe.pending.substr(0, MAX_LINE_LENGTH) + '\n');
+            pipe.pending.erase(0, MAX_LINE_LENGTH);
+        }
+        if (eof && !pipe.pending.empty())
+        {
+            onLine(pipe.stream, pipe.pending + '\n');
+            pipe.pending.clear();
+        }
+    }
+}
+
+int ChildProcess::run(const std::string& cmd, const LineHandler& onLine)
+{
+    int outPipe[2], errPipe[2];
+
+    // Close-on-exec, so children of other roots running at the same time don't keep them open
+    if (0 != pipe2(outPipe, O_CLOEXEC))
+    {
+        return -1;
+    }
+    if (0 != pipe2(errPipe, O_CLOEXEC))
+    {
+        close(outPipe[0]);
+        close(outPipe[1]);
+        return -1;
+    }
+
+    Profiler::instance().count(Profiler::COUNTER::CHILD_PROCESSES);
+    const pid_t pid = fork();
+    if (0 == pid)
+    {
+        // dup2 clears close-on-exec on the copies
+        dup2(outPipe[1], STDOUT_FILENO);
+        dup2(errPipe[1], STDERR_FILENO);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    close(outPipe[1]);
+    close(errPipe[1]);
+    if (pid < 0)
+    {
+        close(outPipe[0]);
+        close(errPipe[0]);
+        return -1;
+    }
+
+    Pipe pipes[] = {{outPipe[0], STREAM::OUT, {}}, {errPipe[0], STREAM::ERR, {}}};
+    for (auto& pipe : pipes)
+    {
+        fcntl(pipe.fd, F_SETFL, fcntl(pipe.fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    char buffer[64 * 1024];
+    int open = 2;
+    while (open > 0)
+    {
+        struct pollfd fds[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            fds[i].fd = pipes[i].fd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < 2; ++i)
+        {
+            if ((pipes[i].fd < 0) || (0 == fds[i].revents))
+            {
+                continue;
+            }
+
+            // Drain what is there, the pipe may be full with the child blocked on it
+            ssize_t count;
+            while ((count = read(pipes[i].fd, buffer, sizeof(buffer))) > 0)
+            {
+                pipes[i].pending.append(buffer, count);
+            }
+
+            const bool eof = (0 == count) || ((count < 0) && (EAGAIN != errno) && (EINTR != errno));
+            passLines(pipes[i], onLine, eof);
+            if (eof)
+            {
+                close(pipes[i].fd);
+                pipes[i].fd = -1;
+                --open;
+            }
+        }
+    }
+
+    for (auto& pipe : pipes)
+    {
+        if (pipe.fd >= 0)
+        {
+            close(pipe.fd);
+        }
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (EINTR != errno)
+        {
+            return -1;
+        }
+    }
+    return WIFSIGNALED(status) ? 128 + WTERMSIG(status) : WEXITSTATUS(status);
+}
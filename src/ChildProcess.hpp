@@ -0,0 +1,54 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef CHILDPROCESS_HPP_
+#define CHILDPROCESS_HPP_
+
+#include <functional>
+#include <string>
+
+/*
+ * Runs a shell command with stdout and stderr on separate pipes and reads
+ * both with one poll() loop as data arrives. Output is handed on in whole
+ * lines, however the child chunks its writes, so a line is never split
+ * or mixed with a line of the other stream.
+ */
+class ChildProcess
+{
+public:
+    enum class STREAM
+    {
+        OUT,
+        ERR
+    };
+
+    // Gets each line with its '\n', a last unterminated line gets one added
+    using LineHandler = std::function<void(STREAM stream, const std::string& line)>;
+
+    // Exit code of the command, 128 + signal if it was killed, -1 if it could not be started
+    static int run(const std::string& cmd, const LineHandler& onLine);
+};
+
+#endif /* CHILDPROCESS_HPP_ */
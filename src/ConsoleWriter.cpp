@@ -25,62 +25,132 @@
 #include "ConsoleWriter.hpp"
 
 #include <hd.h>
+#include <unistd.h>
 
-#include <iomanip>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "TextSink.hpp"
+
+namespace
+{
+    // About a megabyte of output the terminal may fall behind before lines are dropped
+    constexpr std::size_t MAX_QUEUED_EVENTS = 8192;
+    // Subscribers may fall further behind, but not without bound
+    constexpr std::size_t MAX_QUEUED_SUBSCRIBER_EVENTS = 65536;
+}
+
+ConsoleWriter::ConsoleWriter()
+    : sink_(new TextSink(std::cout, isatty(STDOUT_FILENO))),
+      renderQueue_([this](const std::deque<ProgressSubscriber::Event>& events) {
+                renderEvents(events);
+            }, MAX_QUEUED_EVENTS),
+      subscriberQueue_([this](const std::deque<ProgressSubscriber::Event>& events) {
+                notifySubscribers(events);
+            }, MAX_QUEUED_SUBSCRIBER_EVENTS)
+{}
+
+void ConsoleWriter::setSink(std::shared_ptr<OutputSink> sink)
+{
+    waitForRenderer();
+    sink_->flush();
+    sink_ = sink;
+}
+
+void ConsoleWriter::addSubscriber(std::shared_ptr<ProgressSubscriber> subscriber)
+{
+    subscribers_.push_back(subscriber);
+}
+
+void ConsoleWriter::flush() const
+{
+    subscriberQueue_.wait();
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->flush();
+}
+
 void ConsoleWriter::printStatus(std::string statusMsg) const
 {
-    std::cout << CONSOLE_RED_MESSAGE_COLOR << "> "
-            << CONSOLE_COLOR_RESET << statusMsg << std::endl;
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->status(statusMsg);
 }
 
 void ConsoleWriter::printError(std::string errorMsg) const
 {
-    std::cout << CONSOLE_RED_MESSAGE_COLOR << "Error: "
-            << CONSOLE_COLOR_RESET << errorMsg << std::endl;
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->error(errorMsg);
 }
 
 void ConsoleWriter::printWarning(std::string warningMsg) const
 {
-    std::cout << CONSOLE_RED_MESSAGE_COLOR << "Warning: "
-            << CONSOLE_COLOR_RESET << warningMsg << std::endl;
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->warning(warningMsg);
 }
 
 void ConsoleWriter::printMessage(MHWD::MESSAGETYPE type, std::string msg) const
 {
-    switch(type)
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->message(type, msg);
+}
+
+void ConsoleWriter::printEvent(const ProgressSubscriber::Event& event) const
+{
+    renderQueue_.push(event);
+    if (!subscribers_.empty())
     {
-        case MHWD::MESSAGETYPE::CONSOLE_OUTPUT:
-            std::cout << CONSOLE_TEXT_OUTPUT_COLOR << msg << CONSOLE_COLOR_RESET;
-            break;
-        case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_START:
-            printStatus("Installing dependency " + msg + "...");
-            break;
-        case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END:
-            printStatus("Successfully installed dependency " + msg);
-            break;
-        case MHWD::MESSAGETYPE::INSTALL_START:
-            printStatus("Installing " + msg + "...");
-            break;
-        case MHWD::MESSAGETYPE::INSTALL_END:
-            printStatus("Successfully installed " + msg);
-            break;
-        case MHWD::MESSAGETYPE::REMOVE_START:
-            printStatus("Removing " + msg + "...");
-            break;
-        case MHWD::MESSAGETYPE::REMOVE_END:
-            printStatus("Successfully removed " + msg);
-            break;
-        default:
-            printError("You shouldn't see this?! Unknown message type!");
-            break;
+        subscriberQueue_.push(event);
+    }
+}
+
+void ConsoleWriter::renderEvents(const std::deque<ProgressSubscriber::Event>& events) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& event : events)
+    {
+        renderEvent(event);
+    }
+    sink_->flush();
+}
+
+void ConsoleWriter::notifySubscribers(const std::deque<ProgressSubscriber::Event>& events) const
+{
+    for (const auto& event : events)
+    {
+        for (const auto& subscriber : subscribers_)
+        {
+            subscriber->event(event);
+        }
+    }
+}
+
+void ConsoleWriter::renderEvent(const ProgressSubscriber::Event& event) const
+{
+    if (MHWD::MESSAGETYPE::CONSOLE_OUTPUT == event.type)
+    {
+        sink_->message(event.type, event.label.empty() ? event.text
+                : "[" + event.label + "] " + event.text);
+    }
+    else if (MHWD::STATUS::SUCCESS == event.status)
+    {
+        sink_->message(event.type, event.label.empty() ? event.configName
+                : event.configName + " [" + event.label + "]");
     }
 }
 
+void ConsoleWriter::waitForRenderer() const
+{
+    renderQueue_.wait();
+}
+
 void ConsoleWriter::printHelp() const
 {
     std::cout << "Usage: mhwd [OPTIONS] <config(s)>\n\n"
@@ -97,10 +167,40 @@ void ConsoleWriter::printHelp() const
             << "  -i/--install <usb/pci> <config(s)>\tinstall driver config(s)\n"
             << "  -ic/--installcustom <usb/pci> <path>\tinstall custom config(s)\n"
             << "  -r/--remove <usb/pci> <config(s)>\tremove driver config(s)\n"
-            << "  -a/--auto <usb/pci> <free/nonfree> <classid>\tauto install configs for classid\n"
+            << "  -a/--auto <usb/pci/all> <free/nonfree> <classid(s)>\tauto install configs for classid(s)\n"
+            << "\t\t\t\t\tbuses and classids may be comma separated,\n"
+            << "\t\t\t\t\tclassids may contain wildcards (\"03*\")\n"
+            << "  --fleet <file(s)/dir(s)>\t\tprint -a choices for each fixture, as JSON\n"
+            << "  --plan\t\t\t\t\tprint what -i/-r/-a would do, change nothing\n"
+            << "  --plan-json\t\t\t\tsame as --plan, as JSON\n"
+            << "  --apply-plan <file>\t\t\trun a plan saved from --plan\n"
+            << "  --root <path>\t\t\t\tinstall into image mounted at path,\n"
+            << "\t\t\t\t\trepeat to provision several roots at once\n"
+            << "  --sync/--nosync\t\t\talways/never sync the package database\n"
+            << "  --sync-max-age <seconds>\t\tsync only if older, default 3600\n"
             << "  --pmcachedir <path>\t\t\tset package manager cache path\n"
             << "  --pmconfig <path>\t\t\tset package manager config\n"
-            << "  --pmroot <path>\t\t\tset package manager root\n" << std::endl;
+            << "  --pmroot <path>\t\t\tset package manager root\n"
+            << "  --dbdir <path>\t\t\tset config database directory\n"
+            << "  --localdir <path>\t\t\tset installed config directory\n"
+            << "  --fixture <file>\t\t\tread devices from fixture instead of probing\n"
+            << "  --fullprobe\t\t\t\trun all libhd probes, not only the bus scan\n"
+            << "  --dumpfixture <file>\t\t\twrite detected devices to fixture file\n"
+            << "  --modalias <module(s)>\t\tprint pci ids of kernel module(s)\n"
+            << "  --modaliasfile <path>\t\t\tset modules.alias file for --modalias\n"
+            << "  --xorgdevices <file> <driver> <identifier> <vendorid> <lines> <screenlines> <device(s)>\n"
+            << "\t\t\t\t\tadd xorg Device/Screen sections, for config scripts\n"
+            << "  --gpustatus\t\t\t\tshow xorg config link, gpu modules and drivers\n"
+            << "  --gpucheck\t\t\t\tremove the xorg config link if it is invalid\n"
+            << "  --gpumodules <load> <blacklist>\tset the modules mhwd-gpu loads and blacklists\n"
+            << "  --kernel <install/remove> <kernel(s)>\tprint the packages mhwd-kernel installs/removes\n"
+            << "  --kernel <list/listinstalled>\t\tprint available/installed kernels\n"
+            << "  --metrics [file]\t\t\tprint or write transaction metrics for node-exporter,\n"
+            << "\t\t\t\t\tof the --root images if given\n"
+            << "  --events-fd <fd>\t\t\twrite progress events to fd, as JSON lines\n"
+            << "  --json\t\t\t\tprint output as JSON records, one per line\n"
+            << "  --profile\t\t\t\tprint timings and counters of each phase\n"
+            << "  -q/--quiet\t\t\t\tonly print errors\n" << std::endl;
 }
 
 void ConsoleWriter::printVersion(std::string& versionMhwd, std::string& yearCopy) const
@@ -112,168 +212,115 @@ void ConsoleWriter::printVersion(std::string& versionMhwd, std::string& yearCopy
             << std::endl;
 }
 
-void ConsoleWriter::listDevices(const std::vector<std::shared_ptr<Device>>& devices, std::string type) const
+void ConsoleWriter::listDevices(const std::vector<std::shared_ptr<Device>>& devices, MHWD::BUS type) const
 {
-    if (devices.empty())
-    {
-        printWarning("No " + type + " devices found!");
-    }
-    else
-    {
-        printStatus(type + " devices:");
-        printLine();
-        std::cout << std::setw(30) << "TYPE"
-                << std::setw(15) << "BUS"
-                << std::setw(8) << "CLASS"
-                << std::setw(8) << "VENDOR"
-                << std::setw(8) << "DEVICE"
-                << std::setw(10) << "CONFIGS" << std::endl;
-        printLine();
-        for (const auto& device : devices)
-        {
-            std::cout << std::setw(30) << device->className_
-                    << std::setw(15) << device->sysfsBusID_
-                    << std::setw(8) << device->classID_
-                    << std::setw(8) << device->vendorID_
-                    << std::setw(8) << device->deviceID_
-                    << std::setw(10) << device->availableConfigs_.size() << std::endl;
-        }
-        std::cout << std::endl << std::endl;
-    }
+    waitForRenderer();
+    sink_->devices(devices, type);
 }
 
 void ConsoleWriter::listConfigs(const std::vector<std::shared_ptr<Config>>& configs, std::string header) const
 {
-    printStatus(header);
-    printLine();
-    std::cout << std::setw(22) << "NAME"
-            << std::setw(22) << "VERSION"
-            << std::setw(20) << "FREEDRIVER"
-            << std::setw(15) << "TYPE" << std::endl;
-    printLine();
-    for (const auto& config : configs)
-    {
-        std::cout << std::setw(22) << config->name_
-                << std::setw(22) << config->version_
-                << std::setw(20) << std::boolalpha << config->freedriver_
-                << std::setw(15) << config->type_ << std::endl;
-    }
-    std::cout << std::endl << std::endl;
+    waitForRenderer();
+    sink_->configs(configs, header);
 }
 
-void ConsoleWriter::printAvailableConfigsInDetail(const std::string& deviceType,
-        const std::vector<std::shared_ptr<Device>>& devices) const
+void ConsoleWriter::listDeviceConfigs(const Device& device, MHWD::BUS typeOfDevice) const
 {
-    bool configFound = false;
-
-    for (const auto& device : devices)
-    {
-        if (device->availableConfigs_.empty() && device->installedConfigs_.empty())
-        {
-            continue;
-        }
-        else
-        {
-            configFound = true;
-
-            printLine();
-            printStatus(
-                    deviceType + " Device: " + device->sysfsID_ + " (" + device->classID_ + ":"
-                    + device->vendorID_ + ":" + device->deviceID_ + ")");
-            std::cout << "  " << device->className_
-                    << " " << device->vendorName_
-                    << " " << device->deviceName_ << std::endl;
-            printLine();
-            if (!device->installedConfigs_.empty())
-            {
-                std::cout << "  > INSTALLED:\n\n";
-                for (auto&& installedConfig : device->installedConfigs_)
-                {
-                    printConfigDetails(*installedConfig);
-                }
-                std::cout << "\n\n";
-            }
-            if (!device->availableConfigs_.empty())
-            {
-                std::cout << "  > AVAILABLE:\n\n";
-                for (auto&& availableConfig : device->availableConfigs_)
-                {
-                    printConfigDetails(*availableConfig);
-                }
-                std::cout << std::endl;
-            }
-        }
-    }
+    waitForRenderer();
+    sink_->deviceConfigs(device, typeOfDevice);
+}
 
-    if (!configFound)
-    {
-        printWarning("no configs for " + deviceType + " devices found!");
-    }
+void ConsoleWriter::printAvailableConfigsInDetail(MHWD::BUS deviceType,
+        const std::vector<std::shared_ptr<Device>>& devices) const
+{
+    waitForRenderer();
+    sink_->availableConfigsInDetail(deviceType, devices);
 }
 
-void ConsoleWriter::printInstalledConfigs(const std::string& deviceType,
+void ConsoleWriter::printInstalledConfigs(MHWD::BUS deviceType,
         const std::vector<std::shared_ptr<Config>>& installedConfigs) const
 {
-    if (installedConfigs.empty())
-    {
-        printWarning("no installed configs for " + deviceType + " devices found!");
-    }
-    else
-    {
-        for (const auto& config : installedConfigs)
-        {
-            printConfigDetails(*config);
-        }
-        std::cout << std::endl;
-    }
+    waitForRenderer();
+    sink_->installedConfigs(deviceType, installedConfigs);
 }
 
 void ConsoleWriter::printConfigDetails(const Config& config) const
 {
-    std::string classids;
-    std::string vendorids;
-    for (const auto& hwd : config.hwdIDs_)
-    {
-        for (const auto& vendorID : hwd.vendorIDs)
-        {
-            vendorids += vendorID + " ";
-        }
+    waitForRenderer();
+    sink_->configDetails(config);
+}
 
-        for (const auto& classID : hwd.classIDs)
-        {
-            classids += classID + " ";
-        }
-    }
-    std::string dependencies;
-    for (const auto& dependency : config.dependencies_)
-    {
-        dependencies += dependency + " ";
-    }
-    std::string conflicts;
-    for (const auto& conflict : config.conflicts_)
+void ConsoleWriter::printTransactionStatus(const std::string& configName, MHWD::STATUS status) const
+{
+    switch (status)
     {
-        conflicts += conflict + " ";
+        case MHWD::STATUS::SUCCESS:
+            break;
+        case MHWD::STATUS::ERROR_CONFLICTS:
+            printError("config '" + configName +
+                    "' conflicts with installed config(s)!");
+            break;
+        case MHWD::STATUS::ERROR_REQUIREMENTS:
+            printError("config '" + configName +
+                    "' is required by installed config(s)!");
+            break;
+        case MHWD::STATUS::ERROR_NOT_INSTALLED:
+            printError("config '" + configName + "' is not installed!");
+            break;
+        case MHWD::STATUS::ERROR_ALREADY_INSTALLED:
+            printWarning("a version of config '" + configName +
+                    "' is already installed!\nUse -f/--force to force installation...");
+            break;
+        case MHWD::STATUS::ERROR_NO_MATCH_LOCAL_CONFIG:
+            printError("passed config does not match with installed config!");
+            break;
+        case MHWD::STATUS::ERROR_SCRIPT_FAILED:
+            printError("script failed!");
+            break;
+        case MHWD::STATUS::ERROR_SET_DATABASE:
+            printError("failed to set database!");
+            break;
     }
+}
 
-    std::cout << "   NAME:\t" << config.name_
-            << "\n   ATTACHED:\t" << config.type_
-            << "\n   VERSION:\t" << config.version_
-            << "\n   INFO:\t" << (config.info_.empty() ? "-" : config.info_)
-            << "\n   PRIORITY:\t" << config.priority_
-            << "\n   FREEDRIVER:\t" << std::boolalpha << config.freedriver_
-            << "\n   DEPENDS:\t" << (dependencies.empty() ? "-" : dependencies)
-            << "\n   CONFLICTS:\t" << (conflicts.empty() ? "-" : conflicts)
-            << "\n   CLASSIDS:\t" << classids
-            << "\n   VENDORIDS:\t" << vendorids << "\n" << std::endl;
+void ConsoleWriter::printPlan(const Plan& plan) const
+{
+    waitForRenderer();
+    sink_->plan(plan);
 }
 
-void ConsoleWriter::printLine() const
+void ConsoleWriter::printFleetResult(const Fleet::Result& result) const
 {
-    std::cout << std::string(80, '-') << std::endl;
+    waitForRenderer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_->fleetResult(result);
+    // A reader of a long fleet run sees each profile when it is done, not when a buffer fills
+    sink_->flush();
+}
+
+void ConsoleWriter::printGpuStatus(const GpuStatus& status) const
+{
+    waitForRenderer();
+    sink_->gpuStatus(status);
+}
+
+void ConsoleWriter::printModaliasIDs(const std::vector<ModaliasIndex::IDs>& modules) const
+{
+    waitForRenderer();
+    sink_->modaliasIDs(modules);
+}
+
+void ConsoleWriter::printProfile(const Profiler& profiler) const
+{
+    waitForRenderer();
+    sink_->profile(profiler);
 }
 
 void ConsoleWriter::printDeviceDetails(hw_item hw, FILE *f) const
 {
+    waitForRenderer();
+    sink_->flush();
+
     std::unique_ptr<hd_data_t> hd_data{new hd_data_t()};
     hd_t *hd = hd_list(hd_data.get(), hw, 1, nullptr);
 
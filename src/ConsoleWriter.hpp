@@ -27,38 +27,70 @@
 
 #include <hd.h>
 
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "Config.hpp"
 #include "Device.hpp"
 #include "Enums.hpp"
+#include "EventQueue.hpp"
+#include "OutputSink.hpp"
+#include "ProgressSubscriber.hpp"
 
 class ConsoleWriter
 {
 public:
+    ConsoleWriter();
+
+    void setSink(std::shared_ptr<OutputSink> sink);
+    void addSubscriber(std::shared_ptr<ProgressSubscriber> subscriber);
+    void flush() const;
     void printStatus(std::string statusMsg) const;
     void printError(std::string errorMsg) const;
     void printWarning(std::string warningMsg) const;
     void printMessage(MHWD::MESSAGETYPE type, std::string str) const;
+    // Printed like printMessage, failed steps are left to printTransactionStatus;
+    // every subscriber gets the event as it is. Events are only queued here, the
+    // terminal and the subscribers each have a thread of their own, so neither
+    // holds up the script whose output is read nor the other. The terminal may
+    // drop output when far behind, subscribers get everything. All other output
+    // waits for the terminal queue, to keep the order.
+    void printEvent(const ProgressSubscriber::Event& event) const;
     void printHelp() const;
     void printVersion(std::string& versionMhwd, std::string& yearCopy) const;
     void listDevices(const std::vector<std::shared_ptr<Device>>& devices,
-            std::string typeOfDevice) const;
+            MHWD::BUS typeOfDevice) const;
     void listConfigs(const std::vector<std::shared_ptr<Config>>& configs,
             std::string header) const;
-    void printAvailableConfigsInDetail(const std::string& deviceType,
+    void listDeviceConfigs(const Device& device, MHWD::BUS typeOfDevice) const;
+    void printAvailableConfigsInDetail(MHWD::BUS deviceType,
             const std::vector<std::shared_ptr<Device>>& devices) const;
-    void printInstalledConfigs(const std::string& deviceType,
+    void printInstalledConfigs(MHWD::BUS deviceType,
             const std::vector<std::shared_ptr<Config>>& installedConfigs) const;
     void printConfigDetails(const Config& config) const;
+    void printTransactionStatus(const std::string& configName, MHWD::STATUS status) const;
+    void printPlan(const Plan& plan) const;
+    void printFleetResult(const Fleet::Result& result) const;
+    void printGpuStatus(const GpuStatus& status) const;
+    void printModaliasIDs(const std::vector<ModaliasIndex::IDs>& modules) const;
+    void printProfile(const Profiler& profiler) const;
     void printDeviceDetails(hw_item hw, FILE *f = stdout) const;
 private:
-    void printLine() const;
+    void renderEvents(const std::deque<ProgressSubscriber::Event>& events) const;
+    void renderEvent(const ProgressSubscriber::Event& event) const;
+    void notifySubscribers(const std::deque<ProgressSubscriber::Event>& events) const;
+    void waitForRenderer() const;
 
-    const char* CONSOLE_COLOR_RESET {"\033[m"};
-    const char* CONSOLE_RED_MESSAGE_COLOR {"\033[1m\033[31m"};
-    const char* CONSOLE_TEXT_OUTPUT_COLOR {"\033[0;32m"};
+    std::shared_ptr<OutputSink> sink_;
+    std::vector<std::shared_ptr<ProgressSubscriber>> subscribers_;
+    // Installers of several roots report at the same time
+    mutable std::mutex mutex_;
+    // Last, so their threads are done before the members they use go
+    mutable EventQueue renderQueue_;
+    mutable EventQueue subscriberQueue_;
 };
 
 #endif /* PRINTER_HPP_ */
@@ -0,0 +1,126 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EventQueue.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "const.h"
+
+EventQueue::EventQueue(Handler handler, std::size_t maxQueued)
+    : handler_(std::move(handler)), maxQueued_(maxQueued)
+{}
+
+EventQueue::~EventQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        changed_.notify_all();
+    }
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+void EventQueue::push(const ProgressSubscriber::Event& event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!thread_.joinable())
+    {
+        thread_ = std::thread(&EventQueue::run, this);
+    }
+
+    // Rather lose output than block the reader; the transaction log has all of it
+    if ((0 != maxQueued_) && (MHWD::MESSAGETYPE::CONSOLE_OUTPUT == event.type)
+            && (queue_.size() >= maxQueued_))
+    {
+        ++skippedLines_;
+        return;
+    }
+    if (0 != skippedLines_)
+    {
+        queue_.push_back(skippedLinesEvent());
+    }
+    queue_.push_back(event);
+    changed_.notify_all();
+}
+
+void EventQueue::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]() {
+                return queue_.empty() && (0 == skippedLines_) && !handling_;
+            });
+}
+
+void EventQueue::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        changed_.wait(lock, [this]() {
+                    return stop_ || !queue_.empty() || (0 != skippedLines_);
+                });
+        if (queue_.empty() && (0 == skippedLines_))
+        {
+            break;
+        }
+
+        // Take everything queued so far and hand it on without holding up push()
+        std::deque<ProgressSubscriber::Event> events;
+        events.swap(queue_);
+        if (0 != skippedLines_)
+        {
+            events.push_back(skippedLinesEvent());
+        }
+        handling_ = true;
+        lock.unlock();
+
+        handler_(events);
+
+        lock.lock();
+        handling_ = false;
+        changed_.notify_all();
+    }
+}
+
+ProgressSubscriber::Event EventQueue::skippedLinesEvent()
+{
+    ProgressSubscriber::Event event;
+    event.type = MHWD::MESSAGETYPE::CONSOLE_OUTPUT;
+    event.time = std::chrono::steady_clock::now();
+    event.droppedLines = skippedLines_;
+    event.text = "[" + std::to_string(skippedLines_)
+            + " lines of output not shown, see the transaction log in " MHWD_LOG_DIR "]\n";
+    skippedLines_ = 0;
+    return event;
+}
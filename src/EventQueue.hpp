@@ -0,0 +1,77 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EVENTQUEUE_HPP_
+#define EVENTQUEUE_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "ProgressSubscriber.hpp"
+
+/*
+ * Hands progress events to a handler on a thread of its own, in batches
+ * of whatever was queued meanwhile, so push() never waits for the
+ * handler. With maxQueued set, output lines pushed while that many
+ * events wait are dropped and a single line saying how many stands in
+ * for them; start and end events are always kept. Without it nothing is
+ * ever dropped.
+ */
+class EventQueue
+{
+public:
+    using Handler = std::function<void(const std::deque<ProgressSubscriber::Event>& events)>;
+
+    explicit EventQueue(Handler handler, std::size_t maxQueued = 0);
+    // Hands on what is still queued before returning
+    ~EventQueue();
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    void push(const ProgressSubscriber::Event& event);
+    // Returns once everything pushed so far went through the handler
+    void wait();
+
+private:
+    void run();
+    // Stands in for the dropped lines, mutex_ held
+    ProgressSubscriber::Event skippedLinesEvent();
+
+    Handler handler_;
+    std::size_t maxQueued_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::deque<ProgressSubscriber::Event> queue_;
+    unsigned long skippedLines_ = 0;
+    bool handling_ = false;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+#endif /* EVENTQUEUE_HPP_ */
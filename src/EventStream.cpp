@@ -0,0 +1,177 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EventStream.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "JsonSink.hpp"
+
+namespace
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    std::string record(const ProgressSubscriber::Event& event)
+    {
+        std::ostringstream line;
+        line << "{\"type\":\"" << MHWD::messageTypeName(event.type) << "\""
+                << ",\"time_us\":" << duration_cast<microseconds>(event.time.time_since_epoch()).count();
+        if (!event.label.empty())
+        {
+            line << ",\"root\":";
+            JsonSink::quote(line, event.label);
+        }
+        if (!event.configName.empty())
+        {
+            line << ",\"config\":";
+            JsonSink::quote(line, event.configName);
+        }
+        if (0 != event.step)
+        {
+            line << ",\"step\":" << event.step << ",\"steps\":" << event.steps;
+        }
+
+        switch (event.type)
+        {
+            case MHWD::MESSAGETYPE::CONSOLE_OUTPUT:
+                line << ",\"stream\":\"" << (event.fromStderr ? "stderr" : "stdout") << "\""
+                        << ",\"text\":";
+                JsonSink::quote(line, event.text);
+                break;
+            case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END:
+            case MHWD::MESSAGETYPE::INSTALL_END:
+            case MHWD::MESSAGETYPE::REMOVE_END:
+                line << ",\"status\":\"" << MHWD::statusName(event.status) << "\""
+                        << ",\"duration_us\":" << duration_cast<microseconds>(event.duration).count();
+                break;
+            default:
+                break;
+        }
+        line << "}\n";
+        return line.str();
+    }
+
+    std::string droppedRecord(std::chrono::steady_clock::time_point time, unsigned long count)
+    {
+        return "{\"type\":\"dropped\",\"time_us\":"
+                + std::to_string(duration_cast<microseconds>(time.time_since_epoch()).count())
+                + ",\"count\":" + std::to_string(count) + "}\n";
+    }
+}
+
+EventStream::EventStream(int fd, std::chrono::milliseconds writeTimeout)
+    : fd_(fd), writeTimeout_(writeTimeout)
+{
+    const int flags = fcntl(fd_, F_GETFL);
+    if (flags >= 0)
+    {
+        fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+void EventStream::event(const Event& event)
+{
+    // Lines the queue dropped before they got here are only counted
+    std::string line;
+    if (0 != event.droppedLines)
+    {
+        dropped_ += event.droppedLines;
+    }
+    else
+    {
+        line = record(event);
+    }
+
+    // Once the reader stalled, nothing waits for it until it took in what is pending
+    const auto deadline = std::chrono::steady_clock::now()
+            + (stalled_ ? std::chrono::milliseconds{0} : writeTimeout_);
+    if (!writePending(deadline))
+    {
+        dropped_ += line.empty() ? 0 : 1;
+        stalled_ = true;
+        return;
+    }
+    if (0 != dropped_)
+    {
+        pending_ = droppedRecord(event.time, dropped_);
+        dropped_ = 0;
+    }
+    pending_ += line;
+    stalled_ = !writePending(deadline);
+}
+
+bool EventStream::writePending(std::chrono::steady_clock::time_point deadline)
+{
+    // A front end that went away must not stop the installation, so the
+    // SIGPIPE of a closed pipe is blocked and dropped instead of delivered
+    sigset_t pipeSignal, previousMask;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, &previousMask);
+
+    std::size_t written = 0;
+    bool failed = false;
+    while ((written < pending_.size()) && !failed)
+    {
+        const ssize_t result = write(fd_, pending_.data() + written, pending_.size() - written);
+        if (result >= 0)
+        {
+            written += result;
+        }
+        else if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+        {
+            // Wait for the reader to make room, but not past the deadline
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count();
+            struct pollfd pollFd{fd_, POLLOUT, 0};
+            failed = (left <= 0) || (poll(&pollFd, 1, static_cast<int>(left)) <= 0);
+        }
+        else if (EINTR != errno)
+        {
+            if (EPIPE == errno)
+            {
+                const struct timespec noWait{0, 0};
+                sigtimedwait(&pipeSignal, nullptr, &noWait);
+            }
+            // Nobody will read the rest
+            written = pending_.size();
+        }
+    }
+    pending_.erase(0, written);
+
+    pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+    return pending_.empty();
+}
@@ -0,0 +1,66 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef EVENTSTREAM_HPP_
+#define EVENTSTREAM_HPP_
+
+#include <chrono>
+#include <string>
+
+#include "ProgressSubscriber.hpp"
+
+/*
+ * Writes every progress event as one JSON object per line to a file
+ * descriptor, such as a pipe set up by a front end. Each line is handed to
+ * write() whole, so on a pipe events never interleave with other output.
+ * Times are in microseconds of the monotonic clock.
+ *
+ * The descriptor is made non-blocking. A reader that takes in nothing for
+ * writeTimeout is taken as stalled: events are then dropped without
+ * waiting, until it reads again and gets a "dropped" record with their
+ * count. So a front end that stops reading never holds up mhwd.
+ */
+class EventStream : public ProgressSubscriber
+{
+public:
+    // The descriptor stays open, it belongs to whoever passed it
+    explicit EventStream(int fd,
+            std::chrono::milliseconds writeTimeout = std::chrono::milliseconds{2000});
+
+    void event(const Event& event) override;
+
+private:
+    // Writes as much of pending_ as the reader takes until deadline, true once all is written
+    bool writePending(std::chrono::steady_clock::time_point deadline);
+
+    int fd_;
+    std::chrono::milliseconds writeTimeout_;
+    // Rest of a line the reader did not take yet, written before anything else
+    std::string pending_;
+    unsigned long dropped_ = 0;
+    bool stalled_ = false;
+};
+
+#endif /* EVENTSTREAM_HPP_ */
@@ -0,0 +1,547 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Installer.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ChildProcess.hpp"
+#include "PackagePlanner.hpp"
+#include "Profiler.hpp"
+#include "vita/string.hpp"
+
+Installer::Installer(const Data::Environment& environment, std::unique_ptr<Data> data,
+        const ConsoleWriter& consoleWriter, const std::string& label)
+    : environment_(environment), dataStore_(std::move(data)), consoleWriter_(consoleWriter),
+      label_(label)
+{}
+
+DataStore& Installer::dataStore()
+{
+    return dataStore_;
+}
+
+const Data::Environment& Installer::environment() const
+{
+    return environment_;
+}
+
+void Installer::setSyncPackageManagerDatabase(bool sync)
+{
+    environment_.syncPackageManagerDatabase = sync;
+}
+
+void Installer::setMetricsStore(std::shared_ptr<MetricsStore> metrics)
+{
+    metrics_ = metrics;
+}
+
+void Installer::setLog(std::shared_ptr<TransactionLog> log)
+{
+    log_ = log;
+}
+
+bool Installer::executePlan(const Plan& plan)
+{
+    bool success = true;
+
+    steps_ = static_cast<unsigned int>(plan.steps.size());
+    for (step_ = 1; step_ <= steps_; ++step_)
+    {
+        const Plan::Step& step = plan.steps[step_ - 1];
+        stepConfigName_ = step.config->name_;
+
+        MHWD::STATUS status = performStep(step);
+        if (MHWD::STATUS::SUCCESS != status)
+        {
+            consoleWriter_.printTransactionStatus(labeled(step.config->name_), status);
+            success = false;
+            break;
+        }
+    }
+
+    // Output from here on belongs to no step
+    step_ = 0;
+    steps_ = 0;
+    stepConfigName_.clear();
+    return success;
+}
+
+bool Installer::downloadPackages(const std::vector<std::string>& packages)
+{
+    Profiler::ScopedTimer timer("Installer::downloadPackages");
+    const auto start = std::chrono::steady_clock::now();
+    // No --needed: installed in this root or not, the script may still upgrade it
+    std::string cmd = "exec pacman --noconfirm";
+
+    cmd += " --cachedir \"" + environment_.PMCachePath + "\"";
+    cmd += " --config \"" + environment_.PMConfigPath + "\"";
+    cmd += " --root \"" + environment_.PMRootPath + "\"";
+    cmd += environment_.syncPackageManagerDatabase ? " -Syw" : " -Sw";
+
+    for (const auto& package : packages)
+    {
+        cmd += " \"" + package + "\"";
+    }
+
+    const int exitCode = runCommand(cmd);
+    recordMetric("", "download", start, exitCode);
+    if (0 != exitCode)
+    {
+        return false;
+    }
+
+    // The database was synced along with the download
+    if (environment_.syncPackageManagerDatabase)
+    {
+        PackagePlanner::recordSync(environment_.PMRootPath);
+        environment_.syncPackageManagerDatabase = false;
+    }
+    return true;
+}
+
+MHWD::STATUS Installer::performStep(const Plan::Step& step)
+{
+    MHWD::STATUS status = MHWD::STATUS::SUCCESS;
+
+    if (MHWD::TRANSACTIONTYPE::REMOVE == step.type)
+    {
+        std::shared_ptr<Config> installedConfig{dataStore_.snapshot()->getInstalledConfig(
+                step.config->name_, step.config->type_)};
+        if (nullptr == installedConfig)
+        {
+            return MHWD::STATUS::ERROR_NOT_INSTALLED;
+        }
+
+        const ProgressSubscriber::Event start{progressEvent(MHWD::MESSAGETYPE::REMOVE_START)};
+        report(start);
+        status = uninstallConfig(installedConfig.get());
+        report(endEvent(MHWD::MESSAGETYPE::REMOVE_END, start, status));
+    }
+    else
+    {
+        const ProgressSubscriber::Event start{progressEvent(step.dependency
+                ? MHWD::MESSAGETYPE::INSTALLDEPENDENCY_START : MHWD::MESSAGETYPE::INSTALL_START)};
+        report(start);
+        status = installConfig(step.config);
+        report(endEvent(step.dependency
+                ? MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END : MHWD::MESSAGETYPE::INSTALL_END, start, status));
+    }
+
+    return status;
+}
+
+bool Installer::copyDirectory(const std::string& source, const std::string& destination)
+{
+    struct stat filestatus;
+
+    if (0 != lstat(destination.c_str(), &filestatus))
+    {
+        if (!createDir(destination))
+        {
+            return false;
+        }
+    }
+    else if (S_ISREG(filestatus.st_mode))
+    {
+        return false;
+    }
+    else if (S_ISDIR(filestatus.st_mode))
+    {
+        if (!removeDirectory(destination))
+        {
+            return false;
+        }
+
+        if (!createDir(destination))
+        {
+            return false;
+        }
+    }
+    struct dirent *dir;
+    DIR *d = opendir(source.c_str());
+
+    if (!d)
+    {
+        return false;
+    }
+    else
+    {
+        bool success = true;
+        while ((dir = readdir(d)) != nullptr)
+        {
+            std::string filename {dir->d_name};
+
+            if (("." == filename) || (".." == filename) || ("" == filename))
+            {
+                continue;
+            }
+            else
+            {
+                std::string sourcePath {source + "/" + filename};
+                std::string destinationPath {destination + "/" + filename};
+                lstat(sourcePath.c_str(), &filestatus);
+
+                if (S_ISREG(filestatus.st_mode))
+                {
+                    if (!copyFile(sourcePath, destinationPath))
+                    {
+                        success = false;
+                    }
+                }
+                else if (S_ISDIR(filestatus.st_mode))
+                {
+                    if (!copyDirectory(sourcePath, destinationPath))
+                    {
+                        success = false;
+                    }
+                }
+            }
+        }
+        closedir(d);
+        return success;
+    }
+}
+
+bool Installer::copyFile(const std::string& source, const std::string destination, const mode_t mode)
+{
+    std::ifstream src(source, std::ios::binary);
+    std::ofstream dst(destination, std::ios::binary);
+    if (!src || !dst)
+    {
+        return false;
+    }
+
+    dst << src.rdbuf();
+    // chmod ignores the umask; changing the umask would race with the installers of other roots
+    chmod(destination.c_str(), mode);
+    return true;
+}
+
+bool Installer::removeDirectory(const std::string& directory)
+{
+    DIR *d = opendir(directory.c_str());
+
+    if (!d)
+    {
+        return false;
+    }
+    else
+    {
+        bool success = true;
+        struct dirent *dir;
+        while ((dir = readdir(d)) != nullptr)
+        {
+            std::string filename {dir->d_name};
+
+            if (("." == filename) || (".." == filename) || ("" == filename))
+            {
+                continue;
+            }
+            else
+            {
+                std::string filepath {directory + "/" + filename};
+                struct stat filestatus;
+                lstat(filepath.c_str(), &filestatus);
+
+                if (S_ISREG(filestatus.st_mode))
+                {
+                    if (0 != unlink(filepath.c_str()))
+                    {
+                        success = false;
+                    }
+                }
+                else if (S_ISDIR(filestatus.st_mode))
+                {
+                    if (!removeDirectory(filepath))
+                    {
+                        success = false;
+                    }
+                }
+            }
+        }
+        closedir(d);
+
+        if (0 != rmdir(directory.c_str()))
+        {
+            success = false;
+        }
+        return success;
+    }
+}
+
+bool Installer::createDir(const std::string& path, const mode_t mode)
+{
+    // mkdir applies the umask, the chmod sets the mode as asked
+    constexpr int SUCCESS = 0;
+    return (SUCCESS == mkdir(path.c_str(), mode)) && (SUCCESS == chmod(path.c_str(), mode));
+}
+
+MHWD::STATUS Installer::installConfig(std::shared_ptr<Config> config)
+{
+    std::string databaseDir;
+    if (MHWD::BUS::USB == config->type_)
+    {
+        databaseDir = dataStore_.snapshot()->environment.USBDatabaseDir;
+    }
+    else
+    {
+        databaseDir = dataStore_.snapshot()->environment.PCIDatabaseDir;
+    }
+
+    if (!runScript(config, MHWD::TRANSACTIONTYPE::INSTALL))
+    {
+        return MHWD::STATUS::ERROR_SCRIPT_FAILED;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::string installedPath{databaseDir + "/" + config->name_};
+    if (!copyDirectory(config->basePath_, installedPath))
+    {
+        recordMetric(config->name_, "database_copy", start, 1);
+        return MHWD::STATUS::ERROR_SET_DATABASE;
+    }
+
+    // Register the local copy, so only devices matching this config are touched
+    const std::string installedConfigPath{installedPath + "/" + MHWD_CONFIG_NAME};
+    std::shared_ptr<Config> installedConfig{new Config(installedConfigPath, config->type_)};
+    if (!installedConfig->readConfigFile(installedConfigPath))
+    {
+        recordMetric(config->name_, "database_copy", start, 1);
+        return MHWD::STATUS::ERROR_SET_DATABASE;
+    }
+    dataStore_.update([&installedConfig](Data& data) {
+        data.addInstalledConfig(installedConfig);
+    });
+    recordMetric(config->name_, "database_copy", start, 0);
+
+    return MHWD::STATUS::SUCCESS;
+}
+
+MHWD::STATUS Installer::uninstallConfig(Config *config)
+{
+    std::shared_ptr<Config> installedConfig{dataStore_.snapshot()->getInstalledConfig(
+            config->name_, config->type_)};
+    
+    // Check if installed
+    if (nullptr == installedConfig)
+    {
+        return MHWD::STATUS::ERROR_NOT_INSTALLED;
+    }
+    else if (installedConfig->basePath_ != config->basePath_)
+    {
+        return MHWD::STATUS::ERROR_NO_MATCH_LOCAL_CONFIG;
+    }
+    else
+    {
+        // Run script
+        if (!runScript(installedConfig, MHWD::TRANSACTIONTYPE::REMOVE))
+        {
+            return MHWD::STATUS::ERROR_SCRIPT_FAILED;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        if (!removeDirectory(installedConfig->basePath_))
+        {
+            recordMetric(installedConfig->name_, "database_remove", start, 1);
+            return MHWD::STATUS::ERROR_SET_DATABASE;
+        }
+
+        dataStore_.update([&installedConfig](Data& data) {
+            data.removeInstalledConfig(installedConfig);
+        });
+        recordMetric(installedConfig->name_, "database_remove", start, 0);
+
+        return MHWD::STATUS::SUCCESS;
+    }
+}
+
+bool Installer::runScript(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE operationType)
+{
+    Profiler::ScopedTimer timer("Mhwd::runScript");
+    const auto start = std::chrono::steady_clock::now();
+    std::string cmd = "exec " + environment_.scriptPath;
+
+    if (MHWD::TRANSACTIONTYPE::REMOVE == operationType)
+    {
+        cmd += " --remove";
+    }
+    else
+    {
+        cmd += " --install";
+    }
+
+    if (environment_.syncPackageManagerDatabase)
+    {
+        cmd += " --sync";
+    }
+
+    cmd += " --cachedir \"" + environment_.PMCachePath + "\"";
+    cmd += " --pmconfig \"" + environment_.PMConfigPath + "\"";
+    cmd += " --pmroot \"" + environment_.PMRootPath + "\"";
+    cmd += " --sysroot \"" + environment_.rootPath + "\"";
+    cmd += " --config \"" + config->configPath_ + "\"";
+
+    // Set all config devices as argument
+    std::vector<std::shared_ptr<Device>> foundDevices;
+    std::vector<std::shared_ptr<Device>> devices;
+    dataStore_.snapshot()->getAllDevicesOfConfig(config, foundDevices);
+
+    for (auto&& foundDevice = foundDevices.begin();
+            foundDevice != foundDevices.end(); ++foundDevice)
+    {
+        bool found = false;
+
+        // Check if already in list
+        for (auto&& dev = devices.begin(); dev != devices.end(); ++dev)
+        {
+            if ((*foundDevice)->sysfsBusID_ == (*dev)->sysfsBusID_
+                    && (*foundDevice)->sysfsID_ == (*dev)->sysfsID_)
+            {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+        {
+            devices.push_back(std::shared_ptr<Device>{*foundDevice});
+        }
+    }
+
+    std::vector<Vita::stringview> busIDFields;
+    for (auto&& dev = devices.begin(); dev != devices.end(); ++dev)
+    {
+        std::string busID = (*dev)->sysfsBusID_;
+
+        if (MHWD::BUS::PCI == config->type_)
+        {
+            Vita::string ids{busID};
+            std::replace(ids.begin(), ids.end(), '.', ':');
+            const std::size_t size = ids.split(':', busIDFields);
+            unsigned long bus, slot, function;
+
+            // Convert to int to remove leading 0: "0000:01:00.0" is passed as "1:0:0"
+            if ((size >= 3) && busIDFields[size - 3].toUnsigned(bus, 16)
+                    && busIDFields[size - 2].toUnsigned(slot, 16)
+                    && busIDFields[size - 1].toUnsigned(function, 16))
+            {
+                busID.clear();
+                Vita::string::appendNumber(busID, bus);
+                busID += ':';
+                Vita::string::appendNumber(busID, slot);
+                busID += ':';
+                Vita::string::appendNumber(busID, function);
+            }
+        }
+
+        cmd += " --device \"" + (*dev)->classID_ + "|" + (*dev)->vendorID_ + "|" + (*dev)->deviceID_
+                + "|" + busID + "\"";
+    }
+
+    const int exitCode = runCommand(cmd);
+    recordMetric(config->name_, (MHWD::TRANSACTIONTYPE::REMOVE == operationType)
+            ? "remove_script" : "install_script", start, exitCode);
+    if (0 != exitCode)
+    {
+        return false;
+    }
+
+    // Only one database sync is required
+    if ((MHWD::TRANSACTIONTYPE::INSTALL == operationType) && environment_.syncPackageManagerDatabase)
+    {
+        PackagePlanner::recordSync(environment_.PMRootPath);
+        environment_.syncPackageManagerDatabase = false;
+    }
+    return true;
+}
+
+int Installer::runCommand(const std::string& cmd)
+{
+    return ChildProcess::run(cmd, [this](ChildProcess::STREAM stream, const std::string& line) {
+                ProgressSubscriber::Event output{progressEvent(MHWD::MESSAGETYPE::CONSOLE_OUTPUT)};
+                output.text = line;
+                output.fromStderr = (ChildProcess::STREAM::ERR == stream);
+                report(output);
+            });
+}
+
+void Installer::report(const ProgressSubscriber::Event& event) const
+{
+    // The log first: it is never behind what the terminal shows
+    if (log_)
+    {
+        log_->event(event);
+    }
+    consoleWriter_.printEvent(event);
+}
+
+void Installer::recordMetric(const std::string& configName, const std::string& phase,
+        std::chrono::steady_clock::time_point start, int exitCode) const
+{
+    if (metrics_)
+    {
+        metrics_->add(environment_.PMRootPath, configName, phase,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(),
+                exitCode);
+    }
+}
+
+ProgressSubscriber::Event Installer::progressEvent(MHWD::MESSAGETYPE type) const
+{
+    ProgressSubscriber::Event event;
+    event.type = type;
+    event.time = std::chrono::steady_clock::now();
+    event.label = label_;
+    event.configName = stepConfigName_;
+    event.step = step_;
+    event.steps = steps_;
+    return event;
+}
+
+ProgressSubscriber::Event Installer::endEvent(MHWD::MESSAGETYPE type,
+        const ProgressSubscriber::Event& start, MHWD::STATUS status) const
+{
+    ProgressSubscriber::Event event{progressEvent(type)};
+    event.status = status;
+    event.duration = event.time - start.time;
+    return event;
+}
+
+std::string Installer::labeled(const std::string& name) const
+{
+    return label_.empty() ? name : name + " [" + label_ + "]";
+}
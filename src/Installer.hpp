@@ -0,0 +1,105 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef INSTALLER_HPP_
+#define INSTALLER_HPP_
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "ConsoleWriter.hpp"
+#include "Data.hpp"
+#include "DataStore.hpp"
+#include "Enums.hpp"
+#include "MetricsStore.hpp"
+#include "Plan.hpp"
+#include "ProgressSubscriber.hpp"
+#include "TransactionLog.hpp"
+
+/*
+ * Carries out plans on one system: runs the mhwd script for each step
+ * and keeps the local config database and the DataStore in sync. Each
+ * root mhwd works on has its own Installer; a non-empty label is added
+ * to everything it prints, so concurrent roots can be told apart.
+ */
+class Installer
+{
+public:
+    Installer(const Data::Environment& environment, std::unique_ptr<Data> data,
+            const ConsoleWriter& consoleWriter, const std::string& label = "");
+
+    DataStore& dataStore();
+    const Data::Environment& environment() const;
+    void setSyncPackageManagerDatabase(bool sync);
+    // Records the duration and outcome of downloads, scripts and database changes
+    void setMetricsStore(std::shared_ptr<MetricsStore> metrics);
+    // Everything printed while a plan runs also goes to the log, null for none
+    void setLog(std::shared_ptr<TransactionLog> log);
+    bool executePlan(const Plan& plan);
+    // One pacman -Sw for everything this root's plan installs, so the script finds it in the cache
+    bool downloadPackages(const std::vector<std::string>& packages);
+
+private:
+    MHWD::STATUS performStep(const Plan::Step& step);
+    MHWD::STATUS installConfig(std::shared_ptr<Config> config);
+    MHWD::STATUS uninstallConfig(Config *config);
+    bool runScript(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE operationType);
+    // Exit code of the command, -1 if it could not be started
+    int runCommand(const std::string& cmd);
+    void recordMetric(const std::string& configName, const std::string& phase,
+            std::chrono::steady_clock::time_point start, int exitCode) const;
+
+    bool copyDirectory(const std::string& source, const std::string& destination);
+    bool copyFile(const std::string& source, const std::string destination, const mode_t mode =
+            S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IROTH);
+    bool removeDirectory(const std::string& directory);
+    bool createDir(const std::string& path, const mode_t mode =
+            S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IROTH | S_IXGRP | S_IXOTH);
+    std::string labeled(const std::string& name) const;
+    // Stamped now, with the root and the step being performed
+    ProgressSubscriber::Event progressEvent(MHWD::MESSAGETYPE type) const;
+    void report(const ProgressSubscriber::Event& event) const;
+    ProgressSubscriber::Event endEvent(MHWD::MESSAGETYPE type,
+            const ProgressSubscriber::Event& start, MHWD::STATUS status) const;
+
+    Data::Environment environment_;
+    DataStore dataStore_;
+    const ConsoleWriter& consoleWriter_;
+    std::string label_;
+    std::shared_ptr<MetricsStore> metrics_;
+    std::shared_ptr<TransactionLog> log_;
+    // The step executePlan is at, counting from 1, 0 outside of a plan
+    unsigned int step_ = 0;
+    unsigned int steps_ = 0;
+    std::string stepConfigName_;
+};
+
+#endif /* INSTALLER_HPP_ */
@@ -0,0 +1,549 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "JsonSink.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+JsonSink::JsonSink(std::ostream& out)
+    : out_(out)
+{}
+
+void JsonSink::status(const std::string& statusMsg)
+{
+    record("status", "message", statusMsg);
+}
+
+void JsonSink::error(const std::string& errorMsg)
+{
+    record("error", "message", errorMsg);
+}
+
+void JsonSink::warning(const std::string& warningMsg)
+{
+    record("warning", "message", warningMsg);
+}
+
+void JsonSink::message(MHWD::MESSAGETYPE type, const std::string& msg)
+{
+    record(MHWD::messageTypeName(type),
+            (MHWD::MESSAGETYPE::CONSOLE_OUTPUT == type) ? "text" : "config", msg);
+}
+
+void JsonSink::devices(const std::vector<std::shared_ptr<Device>>& devices,
+        MHWD::BUS typeOfDevice)
+{
+    for (const auto& device : devices)
+    {
+        beginRecord("device");
+        writeKey("bus");
+        writeString(MHWD::busName(typeOfDevice));
+        out_ << ',';
+        writeDevice(*device);
+        out_ << ',';
+        writeKey("configs");
+        out_ << device->availableConfigs_.size();
+        endRecord();
+    }
+}
+
+void JsonSink::configs(const std::vector<std::shared_ptr<Config>>& configs,
+        const std::string& header)
+{
+    for (const auto& config : configs)
+    {
+        beginRecord("config");
+        writeKey("list");
+        writeString(header);
+        out_ << ',';
+        writeConfig(*config);
+        endRecord();
+    }
+}
+
+void JsonSink::deviceConfigs(const Device& device, MHWD::BUS typeOfDevice)
+{
+    for (const auto& config : device.availableConfigs_)
+    {
+        beginRecord("config");
+        writeKey("bus");
+        writeString(MHWD::busName(typeOfDevice));
+        out_ << ',';
+        writeKey("busid");
+        writeString(device.sysfsBusID_);
+        out_ << ',';
+        writeKey("classid");
+        writeString(device.classID_);
+        out_ << ',';
+        writeKey("vendorid");
+        writeString(device.vendorID_);
+        out_ << ',';
+        writeKey("deviceid");
+        writeString(device.deviceID_);
+        out_ << ',';
+        writeKey("classname");
+        writeString(device.className_);
+        out_ << ',';
+        writeKey("vendorname");
+        writeString(device.vendorName_);
+        out_ << ',';
+        writeConfig(*config);
+        endRecord();
+    }
+}
+
+void JsonSink::availableConfigsInDetail(MHWD::BUS deviceType,
+        const std::vector<std::shared_ptr<Device>>& devices)
+{
+    for (const auto& device : devices)
+    {
+        if (device->availableConfigs_.empty() && device->installedConfigs_.empty())
+        {
+            continue;
+        }
+
+        beginRecord("device_configs");
+        writeKey("bus");
+        writeString(MHWD::busName(deviceType));
+        out_ << ',';
+        writeDevice(*device);
+        out_ << ',';
+        writeKey("installed");
+        writeConfigs(device->installedConfigs_);
+        out_ << ',';
+        writeKey("available");
+        writeConfigs(device->availableConfigs_);
+        endRecord();
+    }
+}
+
+void JsonSink::installedConfigs(MHWD::BUS deviceType,
+        const std::vector<std::shared_ptr<Config>>& installedConfigs)
+{
+    for (const auto& config : installedConfigs)
+    {
+        beginRecord("installed_config");
+        writeKey("bus");
+        writeString(MHWD::busName(deviceType));
+        out_ << ',';
+        writeConfig(*config);
+        endRecord();
+    }
+}
+
+void JsonSink::configDetails(const Config& config)
+{
+    beginRecord("config_details");
+    writeConfig(config);
+    endRecord();
+}
+
+void JsonSink::plan(const Plan& plan)
+{
+    beginRecord("plan");
+    if (!plan.root.empty())
+    {
+        writeKey("root");
+        writeString(plan.root);
+        out_ << ',';
+    }
+    writeKey("sync");
+    out_ << (plan.sync ? "true" : "false") << ',';
+    writeKey("steps");
+    out_ << '[';
+    bool first = true;
+    for (const auto& step : plan.steps)
+    {
+        out_ << (first ? "{" : ",{");
+        first = false;
+        writeKey("action");
+        writeString(MHWD::TRANSACTIONTYPE::INSTALL == step.type ? "install" : "remove");
+        out_ << ',';
+        writeKey("dependency");
+        out_ << (step.dependency ? "true" : "false") << ',';
+        writeConfig(*step.config);
+        out_ << ',';
+        writeKey("removed_packages");
+        writeStrings(step.removedPackages);
+        out_ << ',';
+        writeKey("installed_packages");
+        writeStrings(step.installedPackages);
+        out_ << '}';
+    }
+    out_ << ']';
+    endRecord();
+}
+
+void JsonSink::fleetResult(const Fleet::Result& result)
+{
+    beginRecord("fleet");
+    writeKey("profile");
+    writeString(result.profilePath);
+    if (!result.error.empty())
+    {
+        out_ << ',';
+        writeKey("error");
+        writeString(result.error);
+        endRecord();
+        return;
+    }
+    out_ << ',';
+    writeKey("selections");
+    out_ << '[';
+    bool first = true;
+    for (const auto& selection : result.selections)
+    {
+        out_ << (first ? "{" : ",{");
+        first = false;
+        writeKey("bus");
+        writeString(MHWD::busName(selection.device->type_));
+        out_ << ',';
+        writeDevice(*selection.device);
+        out_ << ',';
+        writeKey("config");
+        if (selection.config)
+        {
+            writeString(selection.config->name_);
+        }
+        else
+        {
+            out_ << "null";
+        }
+        out_ << '}';
+    }
+    out_ << "],";
+    writeKey("unmatched_classids");
+    writeStrings(result.unmatchedClassIDs);
+    endRecord();
+}
+
+void JsonSink::gpuStatus(const GpuStatus& status)
+{
+    beginRecord("gpustatus");
+    writeKey("xorgconfig");
+    writeString(status.xorgConfigPath);
+    out_ << ',';
+    writeKey("xorgconfigtarget");
+    writeString(status.xorgConfigTarget);
+    out_ << ',';
+    writeKey("xorgconfigexists");
+    out_ << (status.xorgConfigExists ? "true" : "false") << ',';
+    writeKey("modules");
+    out_ << '[';
+    for (auto&& module = status.modules.begin(); module != status.modules.end(); ++module)
+    {
+        out_ << ((module == status.modules.begin()) ? "{" : ",{");
+        writeKey("name");
+        writeString(module->name);
+        out_ << ',';
+        writeKey("loaded");
+        out_ << (module->loaded ? "true" : "false") << '}';
+    }
+    out_ << "],";
+    writeKey("blacklist");
+    out_ << '[';
+    for (auto&& entry = status.blacklist.begin(); entry != status.blacklist.end(); ++entry)
+    {
+        out_ << ((entry == status.blacklist.begin()) ? "{" : ",{");
+        writeKey("module");
+        writeString(entry->module);
+        out_ << ',';
+        writeKey("file");
+        writeString(entry->file);
+        out_ << ',';
+        writeKey("loaded");
+        out_ << (entry->loaded ? "true" : "false") << '}';
+    }
+    out_ << "],";
+    writeKey("gpus");
+    out_ << '[';
+    for (auto&& gpu = status.gpus.begin(); gpu != status.gpus.end(); ++gpu)
+    {
+        out_ << ((gpu == status.gpus.begin()) ? "{" : ",{");
+        writeKey("sysfsbusid");
+        writeString(gpu->sysfsBusID);
+        out_ << ',';
+        writeKey("classid");
+        writeString(gpu->classID);
+        out_ << ',';
+        writeKey("vendorid");
+        writeString(gpu->vendorID);
+        out_ << ',';
+        writeKey("deviceid");
+        writeString(gpu->deviceID);
+        out_ << ',';
+        writeKey("driver");
+        writeString(gpu->driver);
+        out_ << '}';
+    }
+    out_ << ']';
+    endRecord();
+}
+
+void JsonSink::modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules)
+{
+    for (const auto& ids : modules)
+    {
+        beginRecord("modalias");
+        writeKey("module");
+        writeString(ids.module);
+        out_ << ',';
+        writeKey("classids");
+        writeStrings(ids.classIDs);
+        out_ << ',';
+        writeKey("vendorids");
+        writeStrings(ids.vendorIDs);
+        out_ << ',';
+        writeKey("deviceids");
+        writeStrings(ids.deviceIDs);
+        endRecord();
+    }
+}
+
+void JsonSink::profile(const Profiler& profiler)
+{
+    beginRecord("profile");
+    writeKey("phases");
+    out_ << '[';
+    bool first = true;
+    for (const auto& phase : profiler.phases())
+    {
+        out_ << (first ? "{" : ",{");
+        first = false;
+        writeKey("name");
+        writeString(phase.name);
+        out_ << ',';
+        writeKey("calls");
+        out_ << phase.calls << ',';
+        writeKey("ms");
+        out_ << phase.milliseconds << '}';
+    }
+    out_ << "],";
+    writeKey("counters");
+    out_ << '{';
+    for (int counter = 0; counter < static_cast<int>(Profiler::COUNTER::COUNT); ++counter)
+    {
+        const auto type = static_cast<Profiler::COUNTER>(counter);
+        if (counter > 0)
+        {
+            out_ << ',';
+        }
+        writeKey(Profiler::counterName(type));
+        out_ << profiler.counter(type);
+    }
+    out_ << '}';
+    endRecord();
+}
+
+void JsonSink::flush()
+{
+    out_.flush();
+}
+
+void JsonSink::record(const char* type, const std::string& key, const std::string& value)
+{
+    beginRecord(type);
+    writeKey(key.c_str());
+    writeString(value);
+    endRecord();
+}
+
+void JsonSink::beginRecord(const char* type)
+{
+    out_ << "{\"type\":\"" << type << "\",";
+}
+
+void JsonSink::endRecord()
+{
+    out_ << "}\n";
+}
+
+void JsonSink::writeKey(const char* key)
+{
+    out_ << '"' << key << "\":";
+}
+
+void JsonSink::writeString(const std::string& value)
+{
+    quote(out_, value);
+}
+
+void JsonSink::quote(std::ostream& out, const std::string& value)
+{
+    out << '"';
+    for (const char c : value)
+    {
+        switch (c)
+        {
+            case '"':
+                out << "\\\"";
+                break;
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '\r':
+                out << "\\r";
+                break;
+            case '\t':
+                out << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                }
+                else
+                {
+                    out << c;
+                }
+                break;
+        }
+    }
+    out << '"';
+}
+
+template<typename T>
+void JsonSink::writeStrings(const std::vector<T>& values)
+{
+    out_ << '[';
+    for (auto&& value = values.begin(); value != values.end(); ++value)
+    {
+        if (value != values.begin())
+        {
+            out_ << ',';
+        }
+        writeString(*value);
+    }
+    out_ << ']';
+}
+
+void JsonSink::writeDevice(const Device& device)
+{
+    writeKey("sysfsbusid");
+    writeString(device.sysfsBusID_);
+    out_ << ',';
+    writeKey("sysfsid");
+    writeString(device.sysfsID_);
+    out_ << ',';
+    writeKey("classid");
+    writeString(device.classID_);
+    out_ << ',';
+    writeKey("vendorid");
+    writeString(device.vendorID_);
+    out_ << ',';
+    writeKey("deviceid");
+    writeString(device.deviceID_);
+    out_ << ',';
+    writeKey("classname");
+    writeString(device.className_);
+    out_ << ',';
+    writeKey("vendorname");
+    writeString(device.vendorName_);
+    out_ << ',';
+    writeKey("devicename");
+    writeString(device.deviceName_);
+}
+
+void JsonSink::writeConfig(const Config& config)
+{
+    writeKey("name");
+    writeString(config.name_);
+    out_ << ',';
+    writeKey("attached");
+    writeString(MHWD::busName(config.type_));
+    out_ << ',';
+    writeKey("version");
+    writeString(config.version_);
+    out_ << ',';
+    writeKey("info");
+    writeString(config.info_);
+    out_ << ',';
+    writeKey("priority");
+    out_ << config.priority_ << ',';
+    writeKey("freedriver");
+    out_ << (config.freedriver_ ? "true" : "false") << ',';
+    writeKey("path");
+    writeString(config.configPath_);
+    out_ << ',';
+    writeKey("depends");
+    writeStrings(config.dependencies_);
+    out_ << ',';
+    writeKey("conflicts");
+    writeStrings(config.conflicts_);
+    out_ << ',';
+    writeKey("hwdids");
+    out_ << '[';
+    for (auto&& hwdID = config.hwdIDs_.begin(); hwdID != config.hwdIDs_.end(); ++hwdID)
+    {
+        if (hwdID != config.hwdIDs_.begin())
+        {
+            out_ << ',';
+        }
+        out_ << '{';
+        writeKey("classids");
+        writeStrings(hwdID->classIDs);
+        out_ << ',';
+        writeKey("vendorids");
+        writeStrings(hwdID->vendorIDs);
+        out_ << ',';
+        writeKey("deviceids");
+        writeStrings(hwdID->deviceIDs);
+        out_ << ',';
+        writeKey("blacklistedclassids");
+        writeStrings(hwdID->blacklistedClassIDs);
+        out_ << ',';
+        writeKey("blacklistedvendorids");
+        writeStrings(hwdID->blacklistedVendorIDs);
+        out_ << ',';
+        writeKey("blacklisteddeviceids");
+        writeStrings(hwdID->blacklistedDeviceIDs);
+        out_ << '}';
+    }
+    out_ << ']';
+}
+
+void JsonSink::writeConfigs(const std::vector<std::shared_ptr<Config>>& configs)
+{
+    out_ << '[';
+    for (auto&& config = configs.begin(); config != configs.end(); ++config)
+    {
+        if (config != configs.begin())
+        {
+            out_ << ',';
+        }
+        out_ << '{';
+        writeConfig(**config);
+        out_ << '}';
+    }
+    out_ << ']';
+}
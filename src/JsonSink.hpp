@@ -0,0 +1,83 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef JSONSINK_HPP_
+#define JSONSINK_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "OutputSink.hpp"
+
+/*
+ * Machine readable output: one JSON object per line, written field by
+ * field while walking the data.
+ */
+class JsonSink : public OutputSink
+{
+public:
+    explicit JsonSink(std::ostream& out);
+
+    void status(const std::string& statusMsg) override;
+    void error(const std::string& errorMsg) override;
+    void warning(const std::string& warningMsg) override;
+    void message(MHWD::MESSAGETYPE type, const std::string& msg) override;
+    void devices(const std::vector<std::shared_ptr<Device>>& devices,
+            MHWD::BUS typeOfDevice) override;
+    void configs(const std::vector<std::shared_ptr<Config>>& configs,
+            const std::string& header) override;
+    void deviceConfigs(const Device& device, MHWD::BUS typeOfDevice) override;
+    void availableConfigsInDetail(MHWD::BUS deviceType,
+            const std::vector<std::shared_ptr<Device>>& devices) override;
+    void installedConfigs(MHWD::BUS deviceType,
+            const std::vector<std::shared_ptr<Config>>& installedConfigs) override;
+    void configDetails(const Config& config) override;
+    void plan(const Plan& plan) override;
+    void fleetResult(const Fleet::Result& result) override;
+    void gpuStatus(const GpuStatus& status) override;
+    void modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules) override;
+    void profile(const Profiler& profiler) override;
+    void flush() override;
+
+    // Writes value as a quoted and escaped JSON string
+    static void quote(std::ostream& out, const std::string& value);
+
+private:
+    void record(const char* type, const std::string& key, const std::string& value);
+    void beginRecord(const char* type);
+    void endRecord();
+    void writeKey(const char* key);
+    void writeString(const std::string& value);
+    template<typename T>
+    void writeStrings(const std::vector<T>& values);
+    void writeDevice(const Device& device);
+    void writeConfig(const Config& config);
+    void writeConfigs(const std::vector<std::shared_ptr<Config>>& configs);
+
+    std::ostream& out_;
+};
+
+#endif /* JSONSINK_HPP_ */
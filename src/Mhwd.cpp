@@ -24,11 +24,13 @@
 
 #include "Mhwd.hpp"
 
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
@@ -37,85 +39,244 @@
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "AutoConfigure.hpp"
+#include "EventStream.hpp"
+#include "FixtureDeviceSource.hpp"
+#include "Fleet.hpp"
+#include "GpuStatus.hpp"
+#include "HardwareDeviceSource.hpp"
+#include "JsonSink.hpp"
+#include "KernelPlanner.hpp"
+#include "ModaliasIndex.hpp"
+#include "PackagePlanner.hpp"
+#include "Planner.hpp"
+#include "Profiler.hpp"
+#include "QuietSink.hpp"
+#include "Utils.hpp"
 #include "vita/string.hpp"
+#include "XorgConfig.hpp"
 
-bool Mhwd::performTransaction(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE transactionType)
+bool Mhwd::performTransactions(const std::vector<std::shared_ptr<Config>>& configs,
+        MHWD::TRANSACTIONTYPE transactionType, bool skipInstalled)
 {
-    Transaction transaction (data_, config, transactionType,
-            arguments_.FORCE);
+    Profiler::ScopedTimer timer("Mhwd::performTransaction");
+    std::vector<Plan> plans(installers_.size());
+    std::vector<std::shared_ptr<Config>> dependencies;
+    for (std::size_t i = 0; i < roots_.size(); ++i)
+    {
+        plans[i].root = roots_[i];
+    }
 
-    // Print things to do
-    if (MHWD::TRANSACTIONTYPE::INSTALL == transactionType)
+    // Plan every root before touching any of them
+    const bool remove = (MHWD::TRANSACTIONTYPE::REMOVE == transactionType);
+    std::shared_ptr<const Data> firstData{installers_.front()->dataStore().snapshot()};
+    for (std::size_t i = 0; i < installers_.size(); ++i)
     {
-        // Print conflicts
-        if (!transaction.conflictedConfigs_.empty())
+        std::shared_ptr<const Data> data{installers_[i]->dataStore().snapshot()};
+        std::vector<std::shared_ptr<Config>> rootConfigs;
+        for (const auto& config : configs)
+        {
+            if (skipInstalled && !arguments_.FORCE && !remove
+                    && (nullptr != data->getInstalledConfig(config->name_, config->type_)))
+            {
+                continue;
+            }
+
+            // Configs were looked up in the first root, each root uses its own copy
+            std::shared_ptr<Config> rootConfig{config};
+            if ((i > 0) && (config == (remove
+                    ? firstData->getInstalledConfig(config->name_, config->type_)
+                    : firstData->getDatabaseConfig(config->name_, config->type_))))
+            {
+                rootConfig = remove ? data->getInstalledConfig(config->name_, config->type_)
+                        : data->getDatabaseConfig(config->name_, config->type_);
+                if (nullptr == rootConfig)
+                {
+                    consoleWriter_.printError("config '" + config->name_ + (remove
+                            ? "' is not installed in root '" : "' does not exist in root '")
+                            + roots_[i] + "', no root was changed!");
+                    return false;
+                }
+            }
+            rootConfigs.push_back(rootConfig);
+        }
+
+        const auto planStart = std::chrono::steady_clock::now();
+        const bool planned = planTransactions(*data, rootConfigs, transactionType, plans[i]);
+        metrics_[i]->add(installers_[i]->environment().PMRootPath, "", "plan",
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - planStart).count(),
+                planned ? 0 : 1);
+        if (!planned)
         {
-            consoleWriter_.printError("config '" + config->name_ + "' conflicts with config(s):" +
-                    gatherConfigContent(transaction.conflictedConfigs_));
+            if (roots_.size() > 1)
+            {
+                consoleWriter_.printError("failed to plan root '" + roots_[i] +
+                        "', no root was changed!");
+            }
             return false;
         }
 
-        // Print dependencies
-        else if (!transaction.dependencyConfigs_.empty())
+        for (const auto& dependency : plans[i].getDependencies())
         {
-            consoleWriter_.printStatus("Dependencies to install:" +
-                    gatherConfigContent(transaction.dependencyConfigs_) +
-                    "\nProceed with installation? [Y/n]");
-            std::string input;
-            std::getline(std::cin, input);
-            return proceedWithInstallation(input);
+            if (std::find_if(dependencies.begin(), dependencies.end(),
+                    [&dependency](const std::shared_ptr<Config>& config) {
+                        return config->name_ == dependency->name_;
+                    }) == dependencies.end())
+            {
+                dependencies.push_back(dependency);
+            }
         }
     }
-    else if (MHWD::TRANSACTIONTYPE::REMOVE == transactionType)
+
+    // Dry run
+    if (arguments_.PLAN)
     {
-        // Print requirements
-        if (!transaction.configsRequirements_.empty())
+        // Each plan starts with its root, so --apply-plan can tell them apart
+        for (const auto& plan : plans)
+        {
+            consoleWriter_.printPlan(plan);
+        }
+        return true;
+    }
+
+    // Print dependencies
+    if (!dependencies.empty())
+    {
+        consoleWriter_.printStatus("Dependencies to install:" +
+                gatherConfigContent(dependencies) +
+                "\nProceed with installation? [Y/n]");
+        std::string input;
+        std::getline(std::cin, input);
+        if (!proceedWithInstallation(input))
         {
-            consoleWriter_.printError("config '" + config->name_ + "' is required by config(s):" +
-                    gatherConfigContent(transaction.configsRequirements_));
             return false;
         }
     }
 
-    MHWD::STATUS status = performTransaction(transaction);
+    return executePlans(plans);
+}
+
+bool Mhwd::planTransactions(const Data& data, const std::vector<std::shared_ptr<Config>>& configs,
+        MHWD::TRANSACTIONTYPE transactionType, Plan& plan)
+{
+    Planner planner{data, arguments_.FORCE};
+    MHWD::STATUS status = planner.plan(configs, transactionType, plan);
 
     switch (status)
     {
         case MHWD::STATUS::SUCCESS:
-            break;
+            return true;
+        // Print conflicts
         case MHWD::STATUS::ERROR_CONFLICTS:
-            consoleWriter_.printError("config '" + config->name_ +
-                    "' conflicts with installed config(s)!");
+            consoleWriter_.printError("config '" + planner.failedConfig_->name_ +
+                    "' conflicts with config(s):" + gatherConfigContent(planner.blockingConfigs_));
             break;
+        // Print requirements
         case MHWD::STATUS::ERROR_REQUIREMENTS:
-            consoleWriter_.printError("config '" + config->name_ +
-                    "' is required by installed config(s)!");
-            break;
-        case MHWD::STATUS::ERROR_NOT_INSTALLED:
-            consoleWriter_.printError("config '" + config->name_ + "' is not installed!");
-            break;
-        case MHWD::STATUS::ERROR_ALREADY_INSTALLED:
-            consoleWriter_.printWarning("a version of config '" + config->name_ +
-                    "' is already installed!\nUse -f/--force to force installation...");
-            break;
-        case MHWD::STATUS::ERROR_NO_MATCH_LOCAL_CONFIG:
-            consoleWriter_.printError("passed config does not match with installed config!");
+            consoleWriter_.printError("config '" + planner.failedConfig_->name_ +
+                    "' is required by config(s):" + gatherConfigContent(planner.blockingConfigs_));
             break;
-        case MHWD::STATUS::ERROR_SCRIPT_FAILED:
-            consoleWriter_.printError("script failed!");
-            break;
-        case MHWD::STATUS::ERROR_SET_DATABASE:
-            consoleWriter_.printError("failed to set database!");
+        default:
+            consoleWriter_.printTransactionStatus(planner.failedConfig_->name_, status);
             break;
     }
+    return false;
+}
+
+bool Mhwd::executePlans(const std::vector<Plan>& plans)
+{
+    // One log for all roots, closed and written out when the plans are done
+    std::shared_ptr<TransactionLog> log{new TransactionLog(MHWD_LOG_DIR, MHWD_LOG_MAX_FILES)};
+    if (!log->isOpen())
+    {
+        consoleWriter_.printWarning("failed to create transaction log '" + log->path() + "'");
+        log.reset();
+    }
+    for (auto& installer : installers_)
+    {
+        installer->setLog(log);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool success = runPlans(plans);
+
+    for (auto& installer : installers_)
+    {
+        installer->setLog(nullptr);
+    }
+    log.reset();
+
+    const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    for (std::size_t i = 0; i < installers_.size(); ++i)
+    {
+        const Data::Environment& environment = installers_[i]->environment();
+        metrics_[i]->add(environment.PMRootPath, "", "transaction", seconds, success ? 0 : 1);
+        if (!metrics_[i]->save())
+        {
+            consoleWriter_.printWarning("failed to save metrics to '" + environment.metricsPath
+                    + "'");
+        }
+    }
+    return success;
+}
+
+bool Mhwd::runPlans(const std::vector<Plan>& plans)
+{
+    // Download everything first so no step waits on the network. Each root
+    // syncs and resolves against its own databases; the cache is shared, so
+    // a package a former root already fetched is not downloaded again.
+    for (std::size_t i = 0; i < installers_.size(); ++i)
+    {
+        std::vector<std::string> packages;
+        for (const auto& step : plans[i].steps)
+        {
+            if (MHWD::TRANSACTIONTYPE::INSTALL != step.type)
+            {
+                continue;
+            }
+            for (const auto& package : step.installedPackages)
+            {
+                if (std::find(packages.begin(), packages.end(), package) == packages.end())
+                {
+                    packages.push_back(package);
+                }
+            }
+        }
+        if (!packages.empty() && !installers_[i]->downloadPackages(packages))
+        {
+            consoleWriter_.printError("failed to download packages, nothing was changed!");
+            return false;
+        }
+    }
+
+    if (1 == installers_.size())
+    {
+        return installers_.front()->executePlan(plans.front());
+    }
 
-    data_.updateInstalledConfigData();
+    // Roots don't share any state but the package cache, so run them side by side
+    std::vector<char> results(installers_.size(), false);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < installers_.size(); ++i)
+    {
+        threads.emplace_back([this, &plans, &results, i]() {
+            results[i] = installers_[i]->executePlan(plans[i]);
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
 
-    return (MHWD::STATUS::SUCCESS == status);
+    return std::find(results.begin(), results.end(), false) == results.end();
 }
 
 bool Mhwd::proceedWithInstallation(const std::string& input) const
@@ -144,693 +305,585 @@ bool Mhwd::isUserRoot() const
     return true;
 }
 
-std::vector<std::string> Mhwd::checkEnvironment() const
+bool Mhwd::dirExists(const std::string& path) const
 {
-    std::vector<std::string> missingDirs;
-    if (!dirExists(MHWD_USB_CONFIG_DIR))
-    {
-        missingDirs.emplace_back(MHWD_USB_CONFIG_DIR);
-    }
-    if (!dirExists(MHWD_PCI_CONFIG_DIR))
-    {
-        missingDirs.emplace_back(MHWD_PCI_CONFIG_DIR);
-    }
-    if (!dirExists(MHWD_USB_DATABASE_DIR))
-    {
-        missingDirs.emplace_back(MHWD_USB_DATABASE_DIR);
-    }
-    if (!dirExists(MHWD_PCI_DATABASE_DIR))
+    struct stat filestatus;
+    if (0 != stat(path.c_str(), &filestatus))
     {
-        missingDirs.emplace_back(MHWD_PCI_DATABASE_DIR);
+        return false;
     }
 
-    return missingDirs;
+    return true;
 }
 
-std::shared_ptr<Config> Mhwd::getInstalledConfig(const std::string& configName,
-        const std::string& configType)
+std::vector<Data::Environment> Mhwd::getEnvironments() const
 {
-    std::vector<std::shared_ptr<Config>>* installedConfigs;
-
-    // Get the right configs
-    if ("USB" == configType)
+    std::vector<Data::Environment> environments;
+    if (roots_.empty())
     {
-        installedConfigs = &data_.installedUSBConfigs;
+        environments.push_back(environment_);
     }
-    else
+    for (const auto& root : roots_)
     {
-        installedConfigs = &data_.installedPCIConfigs;
+        Data::Environment environment{environment_};
+        environment.setRoot(root);
+        environments.push_back(environment);
     }
 
-    auto installedConfig = std::find_if(installedConfigs->begin(), installedConfigs->end(),
-            [configName](const std::shared_ptr<Config>& config) {
-                return configName == config->name_;
-            });
-
-    if (installedConfig != installedConfigs->end())
+    for (auto& environment : environments)
     {
-        return *installedConfig;
+        environment.syncPackageManagerDatabase = needsSync(environment);
     }
-    return nullptr;
+    return environments;
 }
 
-std::shared_ptr<Config> Mhwd::getDatabaseConfig(const std::string& configName,
-        const std::string& configType)
+bool Mhwd::needsSync(const Data::Environment& environment) const
 {
-    std::vector<std::shared_ptr<Config>>* allConfigs;
-
-    // Get the right configs
-    if ("USB" == configType)
-    {
-        allConfigs = &data_.allUSBConfigs;
-    }
-    else
+    if (arguments_.SYNC || arguments_.NOSYNC)
     {
-        allConfigs = &data_.allPCIConfigs;
+        return arguments_.SYNC;
     }
 
-    auto config = std::find_if(allConfigs->begin(), allConfigs->end(),
-            [configName](const std::shared_ptr<Config>& config) {
-                return config->name_ == configName;
-            });
-    if (config != allConfigs->end())
+    const long age = PackagePlanner::syncDatabaseAge(environment.PMRootPath);
+    return (age < 0) || (age > syncMaxAge_);
+}
+
+std::vector<std::string> Mhwd::checkEnvironment(const Data::Environment& environment) const
+{
+    std::vector<std::string> missingDirs;
+    for (const auto& dir : {environment.USBConfigDir, environment.PCIConfigDir,
+            environment.USBDatabaseDir, environment.PCIDatabaseDir})
     {
-        return *config;
+        if (!dirExists(dir))
+        {
+            missingDirs.emplace_back(dir);
+        }
     }
-    return nullptr;
+
+    return missingDirs;
 }
 
-std::shared_ptr<Config> Mhwd::getAvailableConfig(const std::string& configName,
-        const std::string& configType)
+bool Mhwd::createInstallers()
 {
-    std::vector<std::shared_ptr<Device>> *devices;
+    const std::vector<Data::Environment> environments{getEnvironments()};
+    const bool labeled = (environments.size() > 1);
+    std::unique_ptr<Data> data;
 
-    // Get the right devices
-    if ("USB" == configType)
+    // Samples are only saved once plans were executed, each into its own root
+    metrics_.clear();
+    for (const auto& environment : environments)
     {
-        devices = &data_.USBDevices;
+        metrics_.push_back(std::make_shared<MetricsStore>(environment.metricsPath));
     }
-    else
+    const auto probeStart = std::chrono::steady_clock::now();
+    try
+    {
+        if (fixturePath_.empty())
+        {
+            data.reset(new Data(environments.front(), HardwareDeviceSource{arguments_.FULL_PROBE}));
+        }
+        else
+        {
+            data.reset(new Data(environments.front(), FixtureDeviceSource{fixturePath_}));
+        }
+    }
+    catch(const std::runtime_error& e)
     {
-        devices = &data_.PCIDevices;
+        consoleWriter_.printError(e.what());
+        return false;
     }
+    metrics_.front()->add(environments.front().PMRootPath, "", "probe", std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - probeStart).count(), 0);
+    installers_.emplace_back(new Installer(environments.front(), std::move(data), consoleWriter_,
+            labeled ? roots_.front() : ""));
+    installers_.back()->setMetricsStore(metrics_.front());
 
-    for (auto&& device = devices->begin(); device != devices->end();
-            ++device)
+    // Further roots share the probed devices, but read their own database: the
+    // image may ship other configs, and the script only sees those below its root
+    const std::shared_ptr<const Data> probed{installers_.front()->dataStore().snapshot()};
+    for (std::size_t i = 1; i < environments.size(); ++i)
     {
-        if ((*device)->availableConfigs_.empty())
+        std::vector<std::shared_ptr<Device>> PCIDevices;
+        std::vector<std::shared_ptr<Device>> USBDevices;
+        for (const auto& device : probed->PCIDevices)
         {
-            continue;
+            PCIDevices.push_back(std::make_shared<Device>(*device));
         }
-        else
+        for (const auto& device : probed->USBDevices)
         {
-            auto& availableConfigs = (*device)->availableConfigs_;
-            auto availableConfig = std::find_if(availableConfigs.begin(), availableConfigs.end(),
-                    [configName](const std::shared_ptr<Config>& config){
-                        return config->name_ == configName;
-                    });
-            if (availableConfig != availableConfigs.end())
-            {
-                return *availableConfig;
-            }
+            USBDevices.push_back(std::make_shared<Device>(*device));
         }
+        data.reset(new Data(environments[i], PCIDevices, USBDevices));
+        installers_.emplace_back(new Installer(environments[i], std::move(data), consoleWriter_,
+                roots_[i]));
+        installers_.back()->setMetricsStore(metrics_[i]);
     }
-    return nullptr;
+
+    return true;
 }
 
-MHWD::STATUS Mhwd::performTransaction(const Transaction& transaction)
+void Mhwd::setVersionMhwd(std::string versionOfSoftware, std::string yearCopyright)
 {
-    if ((MHWD::TRANSACTIONTYPE::INSTALL == transaction.type_) &&
-            !transaction.conflictedConfigs_.empty())
-    {
-        return MHWD::STATUS::ERROR_CONFLICTS;
-    }
-    else if ((MHWD::TRANSACTIONTYPE::REMOVE == transaction.type_)
-            && !transaction.configsRequirements_.empty())
+    version_ = versionOfSoftware;
+    year_ = yearCopyright;
+}
+
+void Mhwd::tryToParseCmdLineOptions(int argc, char* argv[], bool& autoConfigureNonFreeDriver,
+        MHWD::BUS& operationType, std::vector<MHWD::BUS>& autoConfigureBusTypes,
+        std::vector<std::string>& autoConfigureClassIDs)
+{
+    if (argc <= 1)
     {
-        return MHWD::STATUS::ERROR_REQUIREMENTS;
+        arguments_.LIST_AVAILABLE = true;
     }
-    else
+    for (int nArg = 1; nArg < argc; ++nArg)
     {
-        // Check if already installed
-        std::shared_ptr<Config> installedConfig{getInstalledConfig(transaction.config_->name_,
-                transaction.config_->type_)};
-        MHWD::STATUS status = MHWD::STATUS::SUCCESS;
-
-        if ((MHWD::TRANSACTIONTYPE::REMOVE == transaction.type_)
-                || (installedConfig != nullptr && transaction.isAllowedToReinstall()))
+        const std::string option{ argv[nArg] };
+        if (("-h" == option) || ("--help" == option))
+        {
+            consoleWriter_.printHelp();
+        }
+        else if (("-v" == option) || ("--version" == option))
+        {
+            consoleWriter_.printVersion(version_, year_);
+        }
+        else if (("-f" == option) || ("--force" == option))
+        {
+            arguments_.FORCE = true;
+        }
+        else if (("-d" == option) || ("--detail" == option))
+        {
+            arguments_.DETAIL = true;
+        }
+        else if (("-la" == option) || ("--listall" == option))
+        {
+            arguments_.LIST_ALL = true;
+        }
+        else if (("-li" == option) || ("--listinstalled" == option))
+        {
+            arguments_.LIST_INSTALLED = true;
+        }
+        else if (("-l" == option) || ("--list" == option))
+        {
+            arguments_.LIST_AVAILABLE = true;
+        }
+        else if (("-lh" == option) || ("--listhardware" == option))
+        {
+            arguments_.LIST_HARDWARE = true;
+        }
+        else if ("--json" == option)
+        {
+            consoleWriter_.setSink(std::make_shared<JsonSink>(std::cout));
+        }
+        else if (("-q" == option) || ("--quiet" == option))
+        {
+            consoleWriter_.setSink(std::make_shared<QuietSink>(std::cout, std::cerr));
+        }
+        else if ("--profile" == option)
+        {
+            arguments_.PROFILE = true;
+        }
+        else if ("--pci" == option)
         {
-            if (nullptr == installedConfig)
+            arguments_.SHOW_PCI = true;
+        }
+        else if ("--usb" == option)
+        {
+            arguments_.SHOW_USB = true;
+        }
+        else if (("-a" == option) || ("--auto" == option))
+        {
+            if ((nArg + 3) >= argc)
             {
-                return MHWD::STATUS::ERROR_NOT_INSTALLED;
+                throw std::runtime_error{"invalid use of option: -a/--auto\n"};
             }
             else
             {
-                consoleWriter_.printMessage(MHWD::MESSAGETYPE::REMOVE_START, installedConfig->name_);
-                if (MHWD::STATUS::SUCCESS != (status = uninstallConfig(installedConfig.get())))
-                {
-                    return status;
-                }
-                else
+                const std::string deviceType{ argv[nArg + 1] };
+                const std::string driverType{ argv[nArg + 2] };
+                if (("free" != driverType) && ("nonfree" != driverType))
                 {
-                    consoleWriter_.printMessage(MHWD::MESSAGETYPE::REMOVE_END, installedConfig->name_);
+                    throw std::runtime_error{"invalid use of option: -a/--auto\n"};
                 }
-            }
-        }
 
-        if (MHWD::TRANSACTIONTYPE::INSTALL == transaction.type_)
-        {
-            // Check if already installed but not allowed to reinstall
-            if ((nullptr != installedConfig) && !transaction.isAllowedToReinstall())
-            {
-                return MHWD::STATUS::ERROR_ALREADY_INSTALLED;
-            }
-            else
-            {
-                // Install all dependencies first
-                for (auto&& dependencyConfig = transaction.dependencyConfigs_.end() - 1;
-                        dependencyConfig != transaction.dependencyConfigs_.begin() - 1;
-                        --dependencyConfig)
+                autoConfigureBusTypes.clear();
+                for (auto&& busType : Vita::string{ deviceType }.explode(","))
                 {
-                    consoleWriter_.printMessage(MHWD::MESSAGETYPE::INSTALLDEPENDENCY_START,
-                            (*dependencyConfig)->name_);
-                    if (MHWD::STATUS::SUCCESS != (status = installConfig((*dependencyConfig))))
+                    if ("all" == busType)
+                    {
+                        autoConfigureBusTypes.push_back(MHWD::BUS::PCI);
+                        autoConfigureBusTypes.push_back(MHWD::BUS::USB);
+                    }
+                    else if (("pci" == busType) || ("usb" == busType))
                     {
-                        return status;
+                        autoConfigureBusTypes.push_back(("usb" == busType) ? MHWD::BUS::USB
+                                : MHWD::BUS::PCI);
                     }
                     else
                     {
-                        consoleWriter_.printMessage(MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END,
-                                (*dependencyConfig)->name_);
+                        throw std::runtime_error{"invalid use of option: -a/--auto\n"};
                     }
                 }
 
-                consoleWriter_.printMessage(MHWD::MESSAGETYPE::INSTALL_START, transaction.config_->name_);
-                if (MHWD::STATUS::SUCCESS != (status = installConfig(transaction.config_)))
+                // Class ids may be comma separated and/or follow as separate arguments
+                autoConfigureClassIDs.clear();
+                nArg += 2;
+                while (((nArg + 1) < argc) && ('-' != argv[nArg + 1][0]))
                 {
-                    return status;
+                    ++nArg;
+                    for (auto&& classID : Vita::string{ argv[nArg] }.toLower().explode(","))
+                    {
+                        if (!classID.trim().empty())
+                        {
+                            autoConfigureClassIDs.push_back(classID.trim());
+                        }
+                    }
                 }
-                else
+                if (autoConfigureClassIDs.empty())
                 {
-                    consoleWriter_.printMessage(MHWD::MESSAGETYPE::INSTALL_END,
-                            transaction.config_->name_);
+                    throw std::runtime_error{"invalid use of option: -a/--auto\n"};
                 }
-            }
-        }
-        return status;
-    }
-}
-
-bool Mhwd::copyDirectory(const std::string& source, const std::string& destination)
-{
-    struct stat filestatus;
-
-    if (0 != lstat(destination.c_str(), &filestatus))
-    {
-        if (!createDir(destination))
-        {
-            return false;
-        }
-    }
-    else if (S_ISREG(filestatus.st_mode))
-    {
-        return false;
-    }
-    else if (S_ISDIR(filestatus.st_mode))
-    {
-        if (!removeDirectory(destination))
-        {
-            return false;
-        }
 
-        if (!createDir(destination))
-        {
-            return false;
+                operationType = autoConfigureBusTypes.front();
+                autoConfigureNonFreeDriver = ("nonfree" == driverType);
+                arguments_.AUTOCONFIGURE = true;
+            }
         }
-    }
-    struct dirent *dir;
-    DIR *d = opendir(source.c_str());
-
-    if (!d)
-    {
-        return false;
-    }
-    else
-    {
-        bool success = true;
-        while ((dir = readdir(d)) != nullptr)
+        else if (("-ic" == option) || ("--installcustom" == option))
         {
-            std::string filename {dir->d_name};
-
-            if (("." == filename) || (".." == filename) || ("" == filename))
+            if ((nArg + 1) >= argc)
             {
-                continue;
+                throw std::runtime_error{"invalid use of option: -ic/--installcustom\n"};
             }
             else
             {
-                std::string sourcePath {source + "/" + filename};
-                std::string destinationPath {destination + "/" + filename};
-                lstat(sourcePath.c_str(), &filestatus);
-
-                if (S_ISREG(filestatus.st_mode))
+                const std::string deviceType{ argv[++nArg] };
+                if (("pci" != deviceType) && ("usb" != deviceType))
                 {
-                    if (!copyFile(sourcePath, destinationPath))
-                    {
-                        success = false;
-                    }
+                    throw std::runtime_error{"invalid use of option: -ic/--installcustom\n"};
                 }
-                else if (S_ISDIR(filestatus.st_mode))
+                else
                 {
-                    if (!copyDirectory(sourcePath, destinationPath))
-                    {
-                        success = false;
-                    }
+                    MHWD::parseBus(deviceType, operationType);
+                    arguments_.CUSTOM_INSTALL = true;
                 }
             }
         }
-        closedir(d);
-        return success;
-    }
-}
-
-bool Mhwd::copyFile(const std::string& source, const std::string destination, const mode_t mode)
-{
-    std::ifstream src(source, std::ios::binary);
-    std::ofstream dst(destination, std::ios::binary);
-    if (!src || !dst)
-    {
-        return false;
-    }
-
-    dst << src.rdbuf();
-    mode_t process_mask = umask(0);
-    chmod(destination.c_str(), mode);
-    umask(process_mask);
-    return true;
-}
-
-bool Mhwd::removeDirectory(const std::string& directory)
-{
-    DIR *d = opendir(directory.c_str());
-
-    if (!d)
-    {
-        return false;
-    }
-    else
-    {
-        bool success = true;
-        struct dirent *dir;
-        while ((dir = readdir(d)) != nullptr)
+        else if (("-i" == option) || ("--install" == option))
         {
-            std::string filename {dir->d_name};
-
-            if (("." == filename) || (".." == filename) || ("" == filename))
+            if ((nArg + 1) >= argc)
             {
-                continue;
+                throw std::runtime_error{"invalid use of option: -i/--install\n"};
             }
             else
             {
-                std::string filepath {directory + "/" + filename};
-                struct stat filestatus;
-                lstat(filepath.c_str(), &filestatus);
-
-                if (S_ISREG(filestatus.st_mode))
+                const std::string deviceType{ argv[++nArg] };
+                if (("pci" != deviceType) && ("usb" != deviceType))
                 {
-                    if (0 != unlink(filepath.c_str()))
-                    {
-                        success = false;
-                    }
+                    throw std::runtime_error{"invalid use of option: -i/--install\n"};
                 }
-                else if (S_ISDIR(filestatus.st_mode))
+                else
                 {
-                    if (!removeDirectory(filepath))
-                    {
-                        success = false;
-                    }
+                    MHWD::parseBus(deviceType, operationType);
+                    arguments_.INSTALL = true;
                 }
             }
         }
-        closedir(d);
-
-        if (0 != rmdir(directory.c_str()))
-        {
-            success = false;
-        }
-        return success;
-    }
-}
-
-bool Mhwd::dirExists(const std::string& path) const
-{
-    struct stat filestatus;
-    if (0 != stat(path.c_str(), &filestatus))
-    {
-        return false;
-    }
-
-    return true;
-}
-
-bool Mhwd::createDir(const std::string& path, const mode_t mode)
-{
-    mode_t process_mask = umask(0);
-    int ret = mkdir(path.c_str(), mode);
-    umask(process_mask);
-
-    constexpr unsigned short SUCCESS = 0;
-    return (SUCCESS == ret);
-}
-
-MHWD::STATUS Mhwd::installConfig(std::shared_ptr<Config> config)
-{
-    std::string databaseDir;
-    if ("USB" == config->type_)
-    {
-        databaseDir = MHWD_USB_DATABASE_DIR;
-    }
-    else
-    {
-        databaseDir = MHWD_PCI_DATABASE_DIR;
-    }
-
-    if (!runScript(config, MHWD::TRANSACTIONTYPE::INSTALL))
-    {
-        return MHWD::STATUS::ERROR_SCRIPT_FAILED;
-    }
-
-    if (!copyDirectory(config->basePath_, databaseDir + "/" + config->name_))
-    {
-        return MHWD::STATUS::ERROR_SET_DATABASE;
-    }
-
-    // Installed config vectors have to be updated manual with updateInstalledConfigData(Data*)
-
-    return MHWD::STATUS::SUCCESS;
-}
-
-MHWD::STATUS Mhwd::uninstallConfig(Config *config)
-{
-    std::shared_ptr<Config> installedConfig{getInstalledConfig(config->name_, config->type_)};
-    
-    // Check if installed
-    if (nullptr == installedConfig)
-    {
-        return MHWD::STATUS::ERROR_NOT_INSTALLED;
-    }
-    else if (installedConfig->basePath_ != config->basePath_)
-    {
-        return MHWD::STATUS::ERROR_NO_MATCH_LOCAL_CONFIG;
-    }
-    else
-    {
-        // Run script
-        if (!runScript(installedConfig, MHWD::TRANSACTIONTYPE::REMOVE))
+        else if (("-r" == option) || ("--remove" == option))
         {
-            return MHWD::STATUS::ERROR_SCRIPT_FAILED;
+            if ((nArg + 1) >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: -r/--remove\n"};
+            }
+            else
+            {
+                const std::string deviceType{ argv[++nArg] };
+                if (("pci" != deviceType) && ("usb" != deviceType))
+                {
+                    throw std::runtime_error{"invalid use of option: -r/--remove\n"};
+                }
+                else
+                {
+                    MHWD::parseBus(deviceType, operationType);
+                    arguments_.REMOVE = true;
+                }
+            }
         }
-
-        if (!removeDirectory(installedConfig->basePath_))
+        else if ("--pmcachedir" == option)
         {
-            return MHWD::STATUS::ERROR_SET_DATABASE;
+            if (nArg + 1 >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: --pmcachedir\n"};
+            }
+            else
+            {
+                environment_.PMCachePath = Vita::string(argv[++nArg]).trim("\"").trim();
+            }
         }
-
-        // Installed config vectors have to be updated manual with updateInstalledConfigData(Data*)
-
-        data_.updateInstalledConfigData();
-        
-        return MHWD::STATUS::SUCCESS;
-    }
-}
-
-bool Mhwd::runScript(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE operationType)
-{
-    std::string cmd = "exec " + std::string(MHWD_SCRIPT_PATH);
-
-    if (MHWD::TRANSACTIONTYPE::REMOVE == operationType)
-    {
-        cmd += " --remove";
-    }
-    else
-    {
-        cmd += " --install";
-    }
-
-    if (data_.environment.syncPackageManagerDatabase)
-    {
-        cmd += " --sync";
-    }
-
-    cmd += " --cachedir \"" + data_.environment.PMCachePath + "\"";
-    cmd += " --pmconfig \"" + data_.environment.PMConfigPath + "\"";
-    cmd += " --pmroot \"" + data_.environment.PMRootPath + "\"";
-    cmd += " --config \"" + config->configPath_ + "\"";
-
-    // Set all config devices as argument
-    std::vector<std::shared_ptr<Device>> foundDevices;
-    std::vector<std::shared_ptr<Device>> devices;
-    data_.getAllDevicesOfConfig(config, foundDevices);
-
-    for (auto&& foundDevice = foundDevices.begin();
-            foundDevice != foundDevices.end(); ++foundDevice)
-    {
-        bool found = false;
-
-        // Check if already in list
-        for (auto&& dev = devices.begin(); dev != devices.end(); ++dev)
+        else if ("--pmconfig" == option)
         {
-            if ((*foundDevice)->sysfsBusID_ == (*dev)->sysfsBusID_
-                    && (*foundDevice)->sysfsID_ == (*dev)->sysfsID_)
+            if (nArg + 1 >= argc)
             {
-                found = true;
-                break;
+                throw std::runtime_error{"invalid use of option: --pmconfig\n"};
+            }
+            else
+            {
+                environment_.PMConfigPath = Vita::string(argv[++nArg]).trim("\"").trim();
             }
         }
-
-        if (!found)
+        else if ("--fullprobe" == option)
         {
-            devices.push_back(std::shared_ptr<Device>{*foundDevice});
+            arguments_.FULL_PROBE = true;
         }
-    }
-
-    for (auto&& dev = devices.begin(); dev != devices.end(); ++dev)
-    {
-        Vita::string busID = (*dev)->sysfsBusID_;
-
-        if ("PCI" == config->type_)
+        else if ("--fixture" == option)
         {
-            std::vector<Vita::string> split = Vita::string(busID).replace(".", ":").explode(":");
-            const unsigned long size = split.size();
-
-            if (size >= 3)
+            if (nArg + 1 >= argc)
             {
-                // Convert to int to remove leading 0
-                busID = Vita::string::toStr<int>(std::stoi(split[size - 3], nullptr, 16));
-                busID += ":" + Vita::string::toStr<int>(std::stoi(split[size - 2], nullptr, 16));
-                busID += ":" + Vita::string::toStr<int>(std::stoi(split[size - 1], nullptr, 16));
+                throw std::runtime_error{"invalid use of option: --fixture\n"};
+            }
+            else
+            {
+                fixturePath_ = Vita::string(argv[++nArg]).trim("\"").trim();
             }
         }
-
-        cmd += " --device \"" + (*dev)->classID_ + "|" + (*dev)->vendorID_ + "|" + (*dev)->deviceID_
-                + "|" + busID + "\"";
-    }
-
-    cmd += " 2>&1";
-
-    FILE *in;
-
-    if (!(in = popen(cmd.c_str(), "r")))
-    {
-        return false;
-    }
-    else
-    {
-        char buff[512];
-        while (fgets(buff, sizeof(buff), in) != nullptr)
-        {
-            consoleWriter_.printMessage(MHWD::MESSAGETYPE::CONSOLE_OUTPUT, buff);
-        }
-
-        int stat = pclose(in);
-
-        if (WEXITSTATUS(stat) != 0)
+        else if ("--modalias" == option)
         {
-            return false;
+            if ((nArg + 1 >= argc) || ('-' == argv[nArg + 1][0]))
+            {
+                throw std::runtime_error{"invalid use of option: --modalias\n"};
+            }
+            else
+            {
+                while ((nArg + 1 < argc) && ('-' != argv[nArg + 1][0]))
+                {
+                    modaliasModules_.push_back(argv[++nArg]);
+                }
+                arguments_.MODALIAS = true;
+            }
         }
-        else
+        else if ("--xorgdevices" == option)
         {
-            // Only one database sync is required
-            if (MHWD::TRANSACTIONTYPE::INSTALL == operationType)
+            // <file> <driver> <identifier> <vendorid> <lines> <screenlines> [<device(s)>]
+            if (nArg + 6 >= argc)
             {
-                data_.environment.syncPackageManagerDatabase = false;
+                throw std::runtime_error{"invalid use of option: --xorgdevices\n"};
+            }
+            else
+            {
+                for (int i = 0; i < 6; ++i)
+                {
+                    xorgArguments_.push_back(argv[++nArg]);
+                }
+                while ((nArg + 1 < argc) && ('-' != argv[nArg + 1][0]))
+                {
+                    xorgArguments_.push_back(argv[++nArg]);
+                }
+                arguments_.XORG_DEVICES = true;
             }
-            return true;
         }
-    }
-}
-
-void Mhwd::setVersionMhwd(std::string versionOfSoftware, std::string yearCopyright)
-{
-    version_ = versionOfSoftware;
-    year_ = yearCopyright;
-}
-
-void Mhwd::tryToParseCmdLineOptions(int argc, char* argv[], bool& autoConfigureNonFreeDriver,
-        std::string& operationType, std::string& autoConfigureClassID)
-{
-    if (argc <= 1)
-    {
-        arguments_.LIST_AVAILABLE = true;
-    }
-    for (int nArg = 1; nArg < argc; ++nArg)
-    {
-        const std::string option{ argv[nArg] };
-        if (("-h" == option) || ("--help" == option))
+        else if ("--gpustatus" == option)
         {
-            consoleWriter_.printHelp();
+            arguments_.GPU_STATUS = true;
         }
-        else if (("-v" == option) || ("--version" == option))
+        else if ("--gpucheck" == option)
         {
-            consoleWriter_.printVersion(version_, year_);
+            arguments_.GPU_CHECK = true;
         }
-        else if (("-f" == option) || ("--force" == option))
+        else if ("--gpumodules" == option)
         {
-            arguments_.FORCE = true;
+            // Two space separated lists, either may be empty
+            if (nArg + 2 >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: --gpumodules\n"};
+            }
+            else
+            {
+                for (auto&& modules : {&gpuModules_, &gpuBlacklistedModules_})
+                {
+                    for (const auto& module : Vita::string(argv[++nArg]).explode(" "))
+                    {
+                        if (!module.empty())
+                        {
+                            modules->push_back(module);
+                        }
+                    }
+                }
+                arguments_.GPU_MODULES = true;
+            }
         }
-        else if (("-d" == option) || ("--detail" == option))
+        else if ("--kernel" == option)
         {
-            arguments_.DETAIL = true;
+            if (nArg + 1 >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: --kernel\n"};
+            }
+            else
+            {
+                kernelAction_ = argv[++nArg];
+                while ((nArg + 1 < argc) && ('-' != argv[nArg + 1][0]))
+                {
+                    kernels_.push_back(argv[++nArg]);
+                }
+
+                const bool list = ("list" == kernelAction_) || ("listinstalled" == kernelAction_);
+                const bool change = ("install" == kernelAction_) || ("remove" == kernelAction_);
+                if (!(list && kernels_.empty()) && !(change && !kernels_.empty()))
+                {
+                    throw std::runtime_error{"invalid use of option: --kernel\n"};
+                }
+                arguments_.KERNEL = true;
+            }
         }
-        else if (("-la" == option) || ("--listall" == option))
+        else if ("--metrics" == option)
         {
-            arguments_.LIST_ALL = true;
+            if ((nArg + 1 < argc) && ('-' != argv[nArg + 1][0]))
+            {
+                metricsTextfile_ = Vita::string(argv[++nArg]).trim("\"").trim();
+            }
+            arguments_.METRICS = true;
         }
-        else if (("-li" == option) || ("--listinstalled" == option))
+        else if ("--fleet" == option)
         {
-            arguments_.LIST_INSTALLED = true;
+            if ((nArg + 1 >= argc) || ('-' == argv[nArg + 1][0]))
+            {
+                throw std::runtime_error{"invalid use of option: --fleet\n"};
+            }
+            else
+            {
+                while ((nArg + 1 < argc) && ('-' != argv[nArg + 1][0]))
+                {
+                    fleetPaths_.push_back(argv[++nArg]);
+                }
+                consoleWriter_.setSink(std::make_shared<JsonSink>(std::cout));
+                arguments_.FLEET = true;
+            }
         }
-        else if (("-l" == option) || ("--list" == option))
+        else if ("--modaliasfile" == option)
         {
-            arguments_.LIST_AVAILABLE = true;
+            if (nArg + 1 >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: --modaliasfile\n"};
+            }
+            else
+            {
+                modaliasFile_ = Vita::string(argv[++nArg]).trim("\"").trim();
+            }
         }
-        else if (("-lh" == option) || ("--listhardware" == option))
+        else if ("--plan" == option)
         {
-            arguments_.LIST_HARDWARE = true;
+            arguments_.PLAN = true;
         }
-        else if ("--pci" == option)
+        else if ("--plan-json" == option)
         {
-            arguments_.SHOW_PCI = true;
+            consoleWriter_.setSink(std::make_shared<JsonSink>(std::cout));
+            arguments_.PLAN = true;
         }
-        else if ("--usb" == option)
+        else if ("--apply-plan" == option)
         {
-            arguments_.SHOW_USB = true;
+            if (nArg + 1 >= argc)
+            {
+                throw std::runtime_error{"invalid use of option: --apply-plan\n"};
+            }
+            else
+            {
+                planPath_ = Vita::string(argv[++nArg]).trim("\"").trim();
+                arguments_.APPLY_PLAN = true;
+            }
         }
-        else if (("-a" == option) || ("--auto" == option))
+        else if ("--dumpfixture" == option)
         {
-            if ((nArg + 3) >= argc)
+            if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: -a/--auto\n"};
+                throw std::runtime_error{"invalid use of option: --dumpfixture\n"};
             }
             else
             {
-                const std::string deviceType{ argv[nArg + 1] };
-                const std::string driverType{ argv[nArg + 2] };
-                const std::string classID{ argv[nArg + 3] };
-                if ((("pci" != deviceType) && ("usb" != deviceType))
-                        || (("free" != driverType) && ("nonfree" != driverType)))
-                {
-                    throw std::runtime_error{"invalid use of option: -a/--auto\n"};
-                }
-                else
-                {
-                    operationType = Vita::string{ deviceType }.toUpper();
-                    autoConfigureNonFreeDriver = ("nonfree" == driverType);
-                    autoConfigureClassID = Vita::string(classID).toLower().trim();
-                    arguments_.AUTOCONFIGURE = true;
-                    nArg += 3;
-                }
+                dumpFixturePath_ = Vita::string(argv[++nArg]).trim("\"").trim();
+                arguments_.DUMP_FIXTURE = true;
             }
         }
-        else if (("-ic" == option) || ("--installcustom" == option))
+        else if ("--dbdir" == option)
         {
-            if ((nArg + 1) >= argc)
+            if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: -ic/--installcustom\n"};
+                throw std::runtime_error{"invalid use of option: --dbdir\n"};
             }
             else
             {
-                const std::string deviceType{ argv[++nArg] };
-                if (("pci" != deviceType) && ("usb" != deviceType))
-                {
-                    throw std::runtime_error{"invalid use of option: -ic/--installcustom\n"};
-                }
-                else
-                {
-                    operationType = Vita::string{ deviceType }.toUpper();
-                    arguments_.CUSTOM_INSTALL = true;
-                }
+                setDatabaseDir(Vita::string(argv[++nArg]).trim("\"").trim());
             }
         }
-        else if (("-i" == option) || ("--install" == option))
+        else if ("--localdir" == option)
         {
-            if ((nArg + 1) >= argc)
+            if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: -i/--install\n"};
+                throw std::runtime_error{"invalid use of option: --localdir\n"};
             }
             else
             {
-                const std::string deviceType{ argv[++nArg] };
-                if (("pci" != deviceType) && ("usb" != deviceType))
-                {
-                    throw std::runtime_error{"invalid use of option: -i/--install\n"};
-                }
-                else
-                {
-                    operationType = Vita::string{ deviceType }.toUpper();
-                    arguments_.INSTALL = true;
-                }
+                setLocalDir(Vita::string(argv[++nArg]).trim("\"").trim());
             }
         }
-        else if (("-r" == option) || ("--remove" == option))
+        else if ("--root" == option)
         {
-            if ((nArg + 1) >= argc)
+            if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: -r/--remove\n"};
+                throw std::runtime_error{"invalid use of option: --root\n"};
             }
             else
             {
-                const std::string deviceType{ argv[++nArg] };
-                if (("pci" != deviceType) && ("usb" != deviceType))
-                {
-                    throw std::runtime_error{"invalid use of option: -r/--remove\n"};
-                }
-                else
-                {
-                    operationType = Vita::string{ deviceType }.toUpper();
-                    arguments_.REMOVE = true;
-                }
+                roots_.push_back(Vita::string(argv[++nArg]).trim("\"").trim());
             }
         }
-        else if ("--pmcachedir" == option)
+        else if ("--sync" == option)
+        {
+            arguments_.SYNC = true;
+        }
+        else if ("--nosync" == option)
+        {
+            arguments_.NOSYNC = true;
+        }
+        else if ("--sync-max-age" == option)
         {
             if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: --pmcachedir\n"};
+                throw std::runtime_error{"invalid use of option: --sync-max-age\n"};
             }
             else
             {
-                data_.environment.PMCachePath = Vita::string(argv[++nArg]).trim("\"").trim();
+                try
+                {
+                    syncMaxAge_ = std::stol(argv[++nArg]);
+                }
+                catch(const std::logic_error&)
+                {
+                    throw std::runtime_error{"invalid use of option: --sync-max-age\n"};
+                }
             }
         }
-        else if ("--pmconfig" == option)
+        else if ("--events-fd" == option)
         {
             if (nArg + 1 >= argc)
             {
-                throw std::runtime_error{"invalid use of option: --pmconfig\n"};
+                throw std::runtime_error{"invalid use of option: --events-fd\n"};
             }
             else
             {
-                data_.environment.PMConfigPath = Vita::string(argv[++nArg]).trim("\"").trim();
+                int fd = -1;
+                try
+                {
+                    fd = std::stoi(argv[++nArg]);
+                }
+                catch(const std::logic_error&)
+                {
+                    throw std::runtime_error{"invalid use of option: --events-fd\n"};
+                }
+                if ((fd < 0) || (-1 == fcntl(fd, F_GETFD)))
+                {
+                    throw std::runtime_error{"invalid use of option: --events-fd, "
+                            + std::string{argv[nArg]} + " is not an open file descriptor\n"};
+                }
+                consoleWriter_.addSubscriber(std::make_shared<EventStream>(fd));
             }
         }
         else if ("--pmroot" == option)
@@ -841,7 +894,7 @@ void Mhwd::tryToParseCmdLineOptions(int argc, char* argv[], bool& autoConfigureN
             }
             else
             {
-                data_.environment.PMRootPath = Vita::string(argv[++nArg]).trim("\"").trim();
+                environment_.PMRootPath = Vita::string(argv[++nArg]).trim("\"").trim();
             }
         }
         else if (arguments_.INSTALL || arguments_.REMOVE)
@@ -895,6 +948,32 @@ bool Mhwd::optionsDontInterfereWithEachOther() const
         consoleWriter_.printHelp();
         return false;
     }
+    else if (arguments_.APPLY_PLAN
+            && (arguments_.INSTALL || arguments_.REMOVE || arguments_.AUTOCONFIGURE || arguments_.PLAN))
+    {
+        consoleWriter_.printError("apply-plan option can't be combined with other transaction options!\n");
+        consoleWriter_.printHelp();
+        return false;
+    }
+    else if (arguments_.SYNC && arguments_.NOSYNC)
+    {
+        consoleWriter_.printError("sync and nosync options can only be used separately!\n");
+        consoleWriter_.printHelp();
+        return false;
+    }
+    else if (arguments_.FLEET && (!arguments_.AUTOCONFIGURE || arguments_.PLAN
+            || arguments_.APPLY_PLAN || !roots_.empty()))
+    {
+        consoleWriter_.printError("fleet option needs -a/--auto and no other transaction options!\n");
+        consoleWriter_.printHelp();
+        return false;
+    }
+    else if (arguments_.PLAN && !(arguments_.INSTALL || arguments_.REMOVE || arguments_.AUTOCONFIGURE))
+    {
+        consoleWriter_.printError("nothing to plan?!\n");
+        consoleWriter_.printHelp();
+        return false;
+    }
     else if ((arguments_.REMOVE || arguments_.INSTALL) && configs_.empty())
     {
         consoleWriter_.printError("nothing to do?!\n");
@@ -907,25 +986,42 @@ bool Mhwd::optionsDontInterfereWithEachOther() const
 
 int Mhwd::launch(int argc, char *argv[])
 {
-    std::vector<std::string> missingDirs { checkEnvironment() };
-    if (!missingDirs.empty())
+    const int ret = execute(argc, argv);
+
+    if (arguments_.PROFILE)
     {
-        consoleWriter_.printError("Following directories do not exist:");
-        for (const auto& dir : missingDirs)
-        {
-            consoleWriter_.printStatus(dir);
-        }
-        return 1;
+        consoleWriter_.printProfile(Profiler::instance());
     }
+    consoleWriter_.flush();
+
+    return ret;
+}
 
-    std::string operationType;
+int Mhwd::execute(int argc, char *argv[])
+{
+    // Environment variables set the defaults, command line options override them
+    if (const char* fixture = getenv("MHWD_FIXTURE"))
+    {
+        fixturePath_ = fixture;
+    }
+    if (const char* dbDir = getenv("MHWD_DB_DIR"))
+    {
+        setDatabaseDir(dbDir);
+    }
+    if (const char* localDir = getenv("MHWD_LOCAL_DIR"))
+    {
+        setLocalDir(localDir);
+    }
+
+    MHWD::BUS operationType = MHWD::BUS::PCI;
     bool autoConfigureNonFreeDriver = false;
-    std::string autoConfigureClassID;
+    std::vector<MHWD::BUS> autoConfigureBusTypes;
+    std::vector<std::string> autoConfigureClassIDs;
 
     try
     {
         tryToParseCmdLineOptions(argc, argv, autoConfigureNonFreeDriver, operationType,
-                autoConfigureClassID);
+                autoConfigureBusTypes, autoConfigureClassIDs);
     }
     catch(const std::runtime_error& e)
     {
@@ -939,8 +1035,72 @@ int Mhwd::launch(int argc, char *argv[])
         return 1;
     }
 
+    // Module ids don't need the database or the hardware
+    if (arguments_.MODALIAS)
+    {
+        return printModaliasIDs();
+    }
+    // Neither do xorg sections, the script passes the devices
+    if (arguments_.XORG_DEVICES)
+    {
+        return writeXorgDevices();
+    }
+    if (arguments_.GPU_STATUS || arguments_.GPU_CHECK || arguments_.GPU_MODULES)
+    {
+        return manageGpu();
+    }
+    if (arguments_.KERNEL)
+    {
+        return planKernels();
+    }
+    if (arguments_.METRICS)
+    {
+        return exportMetrics();
+    }
+
+    for (const auto& environment : getEnvironments())
+    {
+        std::vector<std::string> missingDirs { checkEnvironment(environment) };
+        if (!missingDirs.empty())
+        {
+            consoleWriter_.printError("Following directories do not exist:");
+            for (const auto& dir : missingDirs)
+            {
+                consoleWriter_.printStatus(dir);
+            }
+            return 1;
+        }
+    }
+
+    // Recorded profiles replace the hardware, nothing gets installed
+    if (arguments_.FLEET)
+    {
+        return evaluateFleet(AutoConfigure{autoConfigureBusTypes, autoConfigureClassIDs,
+                autoConfigureNonFreeDriver});
+    }
+
+    // On most boots nothing changed: stop before probing and parsing
+    if (arguments_.AUTOCONFIGURE && !arguments_.PLAN)
+    {
+        loadAutoConfigureStates(autoConfigureBusTypes, autoConfigureClassIDs,
+                autoConfigureNonFreeDriver);
+        if (autoConfigureUnchanged())
+        {
+            consoleWriter_.printStatus("Hardware and config database unchanged since the last run, nothing to do.");
+            return 0;
+        }
+    }
+
+    if (!createInstallers())
+    {
+        return 1;
+    }
+
+    // Everything below reads one snapshot of the first root; transactions publish new ones
+    std::shared_ptr<const Data> data{installers_.front()->dataStore().snapshot()};
+
     // Check for invalid configs
-    for (auto&& invalidConfig : data_.invalidConfigs)
+    for (auto&& invalidConfig : data->invalidConfigs)
     {
         consoleWriter_.printWarning("config '" + invalidConfig->configPath_ + "' is invalid!");
     }
@@ -950,9 +1110,9 @@ int Mhwd::launch(int argc, char *argv[])
     // List all configs
     if (arguments_.LIST_ALL && arguments_.SHOW_PCI)
     {
-        if (!data_.allPCIConfigs.empty())
+        if (!data->allPCIConfigs.empty())
         {
-            consoleWriter_.listConfigs(data_.allPCIConfigs, "All PCI configs:");
+            consoleWriter_.listConfigs(data->allPCIConfigs, "All PCI configs:");
         }
         else
         {
@@ -961,9 +1121,9 @@ int Mhwd::launch(int argc, char *argv[])
     }
     if (arguments_.LIST_ALL && arguments_.SHOW_USB)
     {
-        if (!data_.allUSBConfigs.empty())
+        if (!data->allUSBConfigs.empty())
         {
-            consoleWriter_.listConfigs(data_.allUSBConfigs, "All USB configs:");
+            consoleWriter_.listConfigs(data->allUSBConfigs, "All USB configs:");
         }
         else
         {
@@ -976,13 +1136,13 @@ int Mhwd::launch(int argc, char *argv[])
     {
         if (arguments_.DETAIL)
         {
-            consoleWriter_.printInstalledConfigs("PCI", data_.installedPCIConfigs);
+            consoleWriter_.printInstalledConfigs(MHWD::BUS::PCI, data->installedPCIConfigs);
         }
         else
         {
-            if (!data_.installedPCIConfigs.empty())
+            if (!data->installedPCIConfigs.empty())
             {
-                consoleWriter_.listConfigs(data_.installedPCIConfigs, "Installed PCI configs:");
+                consoleWriter_.listConfigs(data->installedPCIConfigs, "Installed PCI configs:");
             }
             else
             {
@@ -994,13 +1154,13 @@ int Mhwd::launch(int argc, char *argv[])
     {
         if (arguments_.DETAIL)
         {
-            consoleWriter_.printInstalledConfigs("USB", data_.installedUSBConfigs);
+            consoleWriter_.printInstalledConfigs(MHWD::BUS::USB, data->installedUSBConfigs);
         }
         else
         {
-            if (!data_.installedUSBConfigs.empty())
+            if (!data->installedUSBConfigs.empty())
             {
-                consoleWriter_.listConfigs(data_.installedUSBConfigs, "Installed USB configs:");
+                consoleWriter_.listConfigs(data->installedUSBConfigs, "Installed USB configs:");
             }
             else
             {
@@ -1014,18 +1174,15 @@ int Mhwd::launch(int argc, char *argv[])
     {
         if (arguments_.DETAIL)
         {
-            consoleWriter_.printAvailableConfigsInDetail("PCI", data_.PCIDevices);
+            consoleWriter_.printAvailableConfigsInDetail(MHWD::BUS::PCI, data->PCIDevices);
         }
         else
         {
-            for (auto&& PCIDevice : data_.PCIDevices)
+            for (auto&& PCIDevice : data->PCIDevices)
             {
                 if (!PCIDevice->availableConfigs_.empty())
                 {
-                    consoleWriter_.listConfigs(PCIDevice->availableConfigs_,
-                            PCIDevice->sysfsBusID_ + " (" + PCIDevice->classID_ + ":"
-                                    + PCIDevice->vendorID_ + ":" + PCIDevice->deviceID_ + ") "
-                                    + PCIDevice->className_ + " " + PCIDevice->vendorName_ + ":");
+                    consoleWriter_.listDeviceConfigs(*PCIDevice, MHWD::BUS::PCI);
                 }
             }
         }
@@ -1035,153 +1192,158 @@ int Mhwd::launch(int argc, char *argv[])
     {
         if (arguments_.DETAIL)
         {
-            consoleWriter_.printAvailableConfigsInDetail("USB", data_.USBDevices);
+            consoleWriter_.printAvailableConfigsInDetail(MHWD::BUS::USB, data->USBDevices);
         }
 
         else
         {
-            for (auto&& USBdevice : data_.USBDevices)
+            for (auto&& USBdevice : data->USBDevices)
             {
                 if (!USBdevice->availableConfigs_.empty())
                 {
-                    consoleWriter_.listConfigs(USBdevice->availableConfigs_,
-                            USBdevice->sysfsBusID_ + " (" + USBdevice->classID_ + ":"
-                            + USBdevice->vendorID_ + ":" + USBdevice->deviceID_ + ") "
-                            + USBdevice->className_ + " " + USBdevice->vendorName_ + ":");
+                    consoleWriter_.listDeviceConfigs(*USBdevice, MHWD::BUS::USB);
                 }
             }
         }
     }
 
+    // Record the devices as fixture
+    if (arguments_.DUMP_FIXTURE)
+    {
+        std::ostringstream fixture;
+        FixtureDeviceSource::write(fixture, data->PCIDevices);
+        FixtureDeviceSource::write(fixture, data->USBDevices);
+        if (!MhwdUtils::writeFileAtomically(dumpFixturePath_, fixture.str()))
+        {
+            consoleWriter_.printError("failed to write fixture '" + dumpFixturePath_ + "'!");
+            return 1;
+        }
+    }
+
     // List hardware information
     if (arguments_.LIST_HARDWARE && arguments_.SHOW_PCI)
     {
-        if (arguments_.DETAIL)
+        if (arguments_.DETAIL && fixturePath_.empty())
         {
             consoleWriter_.printDeviceDetails(hw_pci);
         }
         else
         {
-            consoleWriter_.listDevices(data_.PCIDevices, "PCI");
+            consoleWriter_.listDevices(data->PCIDevices, MHWD::BUS::PCI);
         }
     }
     if (arguments_.LIST_HARDWARE && arguments_.SHOW_USB)
     {
-        if (arguments_.DETAIL)
+        if (arguments_.DETAIL && fixturePath_.empty())
         {
             consoleWriter_.printDeviceDetails(hw_usb);
         }
         else
         {
-            consoleWriter_.listDevices(data_.USBDevices, "USB");
+            consoleWriter_.listDevices(data->USBDevices, MHWD::BUS::USB);
         }
     }
 
     // Auto configuration
     if (arguments_.AUTOCONFIGURE)
     {
-        std::vector<std::shared_ptr<Device>> *devices;
-        std::vector<std::shared_ptr<Config>> *installedConfigs;
+        AutoConfigure autoConfigure(autoConfigureBusTypes, autoConfigureClassIDs,
+                autoConfigureNonFreeDriver);
+        std::vector<std::shared_ptr<Config>> autoConfigs;
+        unsigned int knownDevices = 0;
 
-        if ("USB" == operationType)
+        for (const auto& selection : autoConfigure.select(*data))
         {
-            devices = &data_.USBDevices;
-            installedConfigs = &data_.installedUSBConfigs;
-        }
-        else
-        {
-            devices = &data_.PCIDevices;
-            installedConfigs = &data_.installedPCIConfigs;
-        }
-        bool foundDevice = false;
-        for (auto&& device : *devices)
-        {
-            if (device->classID_ != autoConfigureClassID)
+            const std::shared_ptr<Device>& device = selection.device;
+            const std::shared_ptr<Config>& config = selection.config;
+
+            // Devices configured by the last run keep their configs
+            if (isKnownDevice(*device))
             {
+                ++knownDevices;
                 continue;
             }
-            else
-            {
-                foundDevice = true;
-                std::shared_ptr<Config> config;
 
-                for (auto&& availableConfig : device->availableConfigs_)
-                {
-                    if (autoConfigureNonFreeDriver || availableConfig->freedriver_)
-                    {
-                        config = availableConfig;
-                        break;
-                    }
-                }
+            if (nullptr == config)
+            {
+                consoleWriter_.printWarning(
+                        "No config found for device: " + device->sysfsBusID_ + " ("
+                                + device->classID_ + ":" + device->vendorID_ + ":"
+                                + device->deviceID_ + ") " + device->className_ + " "
+                                + device->vendorName_ + " " + device->deviceName_);
+                continue;
+            }
 
-                if (nullptr == config)
-                {
-                    consoleWriter_.printWarning(
-                            "No config found for device: " + device->sysfsBusID_ + " ("
-                                    + device->classID_ + ":" + device->vendorID_ + ":"
-                                    + device->deviceID_ + ") " + device->className_ + " "
-                                    + device->vendorName_ + " " + device->deviceName_);
-                    continue;
-                }
-                else
-                {
-                    // If force is not set then skip found config
-                    bool skip = false;
-                    if (!arguments_.FORCE)
-                    {
-                        skip = std::find_if(installedConfigs->begin(), installedConfigs->end(),
-                                [&config](const std::shared_ptr<Config>& conf) -> bool {
-                                    return conf->name_ == config->name_;
-                                }) != installedConfigs->end();
-                    }
-                    // Print found config
-                    if (skip)
-                    {
-                        consoleWriter_.printStatus(
-                                "Skipping already installed config '" + config->name_ +
-                                "' for device: " + device->sysfsBusID_ + " (" +
-                                device->classID_ + ":" + device->vendorID_ + ":" +
-                                device->deviceID_ + ") " + device->className_ + " " +
-                                device->vendorName_ + " " + device->deviceName_);
-                    }
-                    else
-                    {
-                        consoleWriter_.printStatus(
-                                "Using config '" + config->name_ + "' for device: " +
-                                device->sysfsBusID_ + " (" + device->classID_ + ":" +
-                                device->vendorID_ + ":" + device->deviceID_ + ") " +
-                                device->className_ + " " + device->vendorName_ + " " +
-                                device->deviceName_);
-                    }
+            // If force is not set then skip found config
+            bool skip = selection.installed && !arguments_.FORCE;
 
-                    bool alreadyInList = std::find(configs_.begin(), configs_.end(), config->name_) != configs_.end();
-                    if (!alreadyInList && !skip)
-                    {
-                        configs_.push_back(config->name_);
-                    }
-                }
+            // Print found config
+            if (skip)
+            {
+                consoleWriter_.printStatus(
+                        "Skipping already installed config '" + config->name_ +
+                        "' for device: " + device->sysfsBusID_ + " (" +
+                        device->classID_ + ":" + device->vendorID_ + ":" +
+                        device->deviceID_ + ") " + device->className_ + " " +
+                        device->vendorName_ + " " + device->deviceName_);
+            }
+            else
+            {
+                consoleWriter_.printStatus(
+                        "Using config '" + config->name_ + "' for device: " +
+                        device->sysfsBusID_ + " (" + device->classID_ + ":" +
+                        device->vendorID_ + ":" + device->deviceID_ + ") " +
+                        device->className_ + " " + device->vendorName_ + " " +
+                        device->deviceName_);
+            }
+
+            bool alreadyInList = std::find(autoConfigs.begin(), autoConfigs.end(), config)
+                    != autoConfigs.end();
+            // Other roots may not have it installed yet
+            if (!alreadyInList && (!skip || (roots_.size() > 1)))
+            {
+                autoConfigs.push_back(config);
             }
         }
 
-        if (!foundDevice)
+        for (const auto& classID : autoConfigure.unmatchedClassIDs(*data))
+        {
+            consoleWriter_.printWarning("No device of class " + classID + " found!");
+        }
+
+        if (knownDevices > 0)
         {
-            consoleWriter_.printWarning("No device of class " + autoConfigureClassID + " found!");
+            consoleWriter_.printStatus("Skipping " + std::to_string(knownDevices) +
+                    " device(s) unchanged since the last run");
         }
-        else if (!configs_.empty())
+
+        // All selected configs go through one transaction: one prompt, one sync
+        if (!autoConfigs.empty())
         {
-            arguments_.INSTALL = true;
+            if (!isUserRoot() && !arguments_.PLAN)
+            {
+                consoleWriter_.printError("You cannot perform this operation unless you are root!");
+                autoConfigureStates_.clear();
+            }
+            else if (!performTransactions(autoConfigs, MHWD::TRANSACTIONTYPE::INSTALL, true))
+            {
+                return 1;
+            }
         }
+
+        saveAutoConfigureStates(autoConfigureBusTypes);
     }
 
     // Transaction
     if (arguments_.INSTALL || arguments_.REMOVE)
     {
-        if (!isUserRoot())
+        if (!isUserRoot() && !arguments_.PLAN)
         {
             consoleWriter_.printError("You cannot perform this operation unless you are root!");
         }
         else
         {
+            std::vector<std::shared_ptr<Config>> transactionConfigs;
             for (auto&& configName = configs_.begin();
                     configName != configs_.end(); configName++)
             {
@@ -1209,19 +1371,14 @@ int Mhwd::launch(int argc, char *argv[])
                             consoleWriter_.printError("failed to read custom config '" + filepath + "'!");
                             return 1;
                         }
-
-                        else if (!performTransaction(config_, MHWD::TRANSACTIONTYPE::INSTALL))
-                        {
-                            return 1;
-                        }
                     }
                 }
                 else if (arguments_.INSTALL)
                 {
-                    config_ = getAvailableConfig((*configName), operationType);
+                    config_ = data->getAvailableConfig((*configName), operationType);
                     if (config_ == nullptr)
                     {
-                        config_ = getDatabaseConfig((*configName), operationType);
+                        config_ = data->getDatabaseConfig((*configName), operationType);
                         if (config_ == nullptr)
                         {
                             consoleWriter_.printError("config '" + (*configName) + "' does not exist!");
@@ -1233,33 +1390,437 @@ int Mhwd::launch(int argc, char *argv[])
                                     "no matching device for config '" + (*configName) + "' found!");
                         }
                     }
-
-                    if (!performTransaction(config_, MHWD::TRANSACTIONTYPE::INSTALL))
-                    {
-                        return 1;
-                    }
                 }
                 else if (arguments_.REMOVE)
                 {
-                    config_ = getInstalledConfig((*configName), operationType);
+                    config_ = data->getInstalledConfig((*configName), operationType);
 
                     if (nullptr == config_)
                     {
                         consoleWriter_.printError("config '" + (*configName) + "' is not installed!");
                         return 1;
                     }
-
-                    else if (!performTransaction(config_, MHWD::TRANSACTIONTYPE::REMOVE))
-                    {
-                        return 1;
-                    }
                 }
+                transactionConfigs.push_back(config_);
+            }
+
+            if (!performTransactions(transactionConfigs, arguments_.REMOVE
+                    ? MHWD::TRANSACTIONTYPE::REMOVE : MHWD::TRANSACTIONTYPE::INSTALL))
+            {
+                return 1;
+            }
+        }
+    }
+
+    // Run a plan made earlier with --plan
+    if (arguments_.APPLY_PLAN)
+    {
+        if (!isUserRoot())
+        {
+            consoleWriter_.printError("You cannot perform this operation unless you are root!");
+        }
+        else if (!applyPlan())
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+bool Mhwd::applyPlan()
+{
+    std::vector<Plan> filePlans;
+    try
+    {
+        std::ifstream file(planPath_);
+        if (!file)
+        {
+            throw std::runtime_error{"failed to open plan '" + planPath_ + "'"};
+        }
+        filePlans = Plan::read(file);
+    }
+    catch(const std::runtime_error& e)
+    {
+        consoleWriter_.printError(e.what());
+        return false;
+    }
+
+    // Each root only gets the plan made for it
+    std::vector<Plan> plans(installers_.size());
+    if (roots_.empty())
+    {
+        if ((filePlans.size() > 1) || (!filePlans.empty() && !filePlans.front().root.empty()))
+        {
+            consoleWriter_.printError("plan '" + planPath_
+                    + "' was made for --root, apply it with the same roots!");
+            return false;
+        }
+        if (!filePlans.empty())
+        {
+            plans.front() = filePlans.front();
+        }
+    }
+    else
+    {
+        for (const auto& plan : filePlans)
+        {
+            auto root = std::find(roots_.begin(), roots_.end(), plan.root);
+            if (plan.root.empty() || (root == roots_.end()))
+            {
+                consoleWriter_.printError("plan '" + planPath_ + "' has a plan for root '" + plan.root
+                        + "', which is not given with --root!");
+                return false;
+            }
+            else if (!plans[root - roots_.begin()].root.empty())
+            {
+                consoleWriter_.printError("plan '" + planPath_ + "' has two plans for root '"
+                        + plan.root + "'!");
+                return false;
+            }
+            plans[root - roots_.begin()] = plan;
+        }
+        for (std::size_t i = 0; i < roots_.size(); ++i)
+        {
+            if (plans[i].root.empty())
+            {
+                consoleWriter_.printError("plan '" + planPath_ + "' has no plan for root '"
+                        + roots_[i] + "'!");
+                return false;
+            }
+        }
+    }
+
+    // Only the configs are read again, to make sure they are still what was planned
+    for (auto& plan : plans)
+    {
+        for (auto&& step : plan.steps)
+        {
+            if (MHWD::TRANSACTIONTYPE::INSTALL != step.type)
+            {
+                continue;
+            }
+
+            std::shared_ptr<Config> config{new Config(step.config->configPath_, step.config->type_)};
+            if (!config->readConfigFile(config->configPath_) || (config->name_ != step.config->name_)
+                    || (config->version_ != step.config->version_))
+            {
+                consoleWriter_.printError("config '" + step.config->name_ +
+                        "' changed since the plan was made, plan again!");
+                return false;
+            }
+            step.config = config;
+        }
+    }
+
+    for (std::size_t i = 0; i < installers_.size(); ++i)
+    {
+        // A database synced since the plan was made needs no second sync
+        installers_[i]->setSyncPackageManagerDatabase(plans[i].sync
+                && installers_[i]->environment().syncPackageManagerDatabase);
+    }
+    return executePlans(plans);
+}
+
+int Mhwd::printModaliasIDs() const
+{
+    try
+    {
+        ModaliasIndex index(modaliasFile_.empty() ? ModaliasIndex::defaultAliasFile() : modaliasFile_);
+        std::vector<ModaliasIndex::IDs> modules;
+
+        // As mhwd-modalias did, modules without pci aliases get empty lists:
+        // database generation loops over every module and reads the output
+        for (const auto& module : modaliasModules_)
+        {
+            modules.push_back(index.ids(module));
+        }
+        consoleWriter_.printModaliasIDs(modules);
+        return 0;
+    }
+    catch(const std::runtime_error& e)
+    {
+        consoleWriter_.printError(e.what());
+        return 1;
+    }
+}
+
+int Mhwd::writeXorgDevices() const
+{
+    unsigned long firstIdentifier;
+    if (!Vita::stringview(xorgArguments_[2]).toUnsigned(firstIdentifier, 10))
+    {
+        consoleWriter_.printError("invalid xorg identifier '" + xorgArguments_[2] + "'!");
+        return 1;
+    }
+
+    // Devices come as the scripts get them: CLASSID|VENDORID|DEVICEID|BUSID
+    std::vector<std::shared_ptr<Device>> devices;
+    std::vector<Vita::stringview> fields;
+    for (auto&& argument = xorgArguments_.begin() + 6; argument != xorgArguments_.end(); ++argument)
+    {
+        const Vita::string deviceArgument{*argument};
+        if (deviceArgument.split('|', fields) != 4)
+        {
+            consoleWriter_.printError("invalid xorg device '" + *argument + "'!");
+            return 1;
+        }
+
+        std::shared_ptr<Device> device{new Device()};
+        device->classID_ = fields[0].str();
+        device->vendorID_ = fields[1].str();
+        device->deviceID_ = fields[2].str();
+        device->sysfsBusID_ = fields[3].str();
+        devices.push_back(device);
+    }
+
+    XorgConfig xorgConfig(xorgArguments_[0]);
+    const unsigned int sections = xorgConfig.addDeviceSections(xorgArguments_[1], devices,
+            xorgArguments_[3], xorgArguments_[4], xorgArguments_[5], firstIdentifier);
+    if (!xorgConfig.write())
+    {
+        consoleWriter_.printError("failed to write '" + xorgArguments_[0] + "'!");
+        return 1;
+    }
+
+    // The script numbers the next sections from here
+    consoleWriter_.flush();
+    std::cout << sections << std::endl;
+    return 0;
+}
+
+int Mhwd::manageGpu() const
+{
+    if ((arguments_.GPU_CHECK || arguments_.GPU_MODULES) && !isUserRoot())
+    {
+        consoleWriter_.printError("You cannot perform this operation unless you are root!");
+        return 1;
+    }
+
+    if (arguments_.GPU_MODULES && !GpuStatus::setModules(gpuModules_, gpuBlacklistedModules_))
+    {
+        consoleWriter_.printError("failed to set the gpu modules!");
+        return 1;
+    }
+
+    if (arguments_.GPU_CHECK)
+    {
+        const GpuStatus status;
+        if (!status.xorgConfigTarget.empty() && !status.xorgConfigExists)
+        {
+            consoleWriter_.printStatus("'" + status.xorgConfigPath + "' symlink is invalid! Removing it...");
+            if (!GpuStatus::removeInvalidXorgConfig())
+            {
+                consoleWriter_.printError("failed to remove '" + status.xorgConfigPath + "'!");
+                return 1;
             }
         }
+        else if (status.xorgConfigExists)
+        {
+            consoleWriter_.printStatus("xorg configuration symlink valid...");
+        }
+    }
+
+    if (arguments_.GPU_STATUS)
+    {
+        consoleWriter_.printGpuStatus(GpuStatus{});
+    }
+    return 0;
+}
+
+int Mhwd::planKernels() const
+{
+    try
+    {
+        const KernelPlanner planner(environment_.PMRootPath, environment_.PMConfigPath);
+        std::vector<std::string> packages;
+
+        if ("list" == kernelAction_)
+        {
+            packages = planner.availableKernels();
+        }
+        else if ("listinstalled" == kernelAction_)
+        {
+            packages = planner.installedKernels();
+        }
+        else if ("install" == kernelAction_)
+        {
+            packages = planner.installPackages(kernels_, KernelPlanner::runningKernel());
+        }
+        else
+        {
+            packages = planner.removePackages(kernels_, KernelPlanner::runningKernel());
+        }
+
+        // One package per line, for mhwd-kernel to hand to a single pacman call
+        consoleWriter_.flush();
+        for (const auto& package : packages)
+        {
+            std::cout << package << '\n';
+        }
+        std::cout.flush();
+        return 0;
+    }
+    catch(const std::runtime_error& e)
+    {
+        consoleWriter_.printError(e.what());
+        return 1;
+    }
+}
+
+int Mhwd::exportMetrics() const
+{
+    // The host's store, or those of the given roots: the samples carry their root
+    std::vector<MetricsStore::Sample> samples;
+    for (const auto& environment : getEnvironments())
+    {
+        const MetricsStore store{environment.metricsPath};
+        const std::vector<MetricsStore::Sample> rootSamples{store.load()};
+        samples.insert(samples.end(), rootSamples.begin(), rootSamples.end());
+    }
+    if (metricsTextfile_.empty())
+    {
+        consoleWriter_.flush();
+        MetricsStore::writeTextfile(std::cout, samples);
+        std::cout.flush();
+        return 0;
+    }
+
+    // The textfile collector only reads *.prom, the temporary file is skipped until renamed
+    std::ostringstream textfile;
+    MetricsStore::writeTextfile(textfile, samples);
+    if (!MhwdUtils::writeFileAtomically(metricsTextfile_, textfile.str()))
+    {
+        consoleWriter_.printError("failed to write metrics to '" + metricsTextfile_ + "'");
+        return 1;
     }
     return 0;
 }
 
+void Mhwd::loadAutoConfigureStates(const std::vector<MHWD::BUS>& busTypes,
+        const std::vector<std::string>& classIDs, bool nonFreeDriver)
+{
+    std::string request;
+    for (const auto& busType : busTypes)
+    {
+        request += std::string{MHWD::busName(busType)} + ",";
+    }
+    request += nonFreeDriver ? "nonfree" : "free";
+    for (const auto& classID : classIDs)
+    {
+        request += "," + classID;
+    }
+
+    for (const auto& environment : getEnvironments())
+    {
+        autoConfigureStates_.emplace_back(new AutoConfigureState(environment, request,
+                busTypes, fixturePath_));
+    }
+}
+
+bool Mhwd::autoConfigureUnchanged() const
+{
+    // Listings still need the hardware and the database
+    if (arguments_.FORCE || autoConfigureStates_.empty() || arguments_.LIST_ALL
+            || arguments_.LIST_INSTALLED || arguments_.LIST_AVAILABLE || arguments_.LIST_HARDWARE
+            || arguments_.DUMP_FIXTURE)
+    {
+        return false;
+    }
+
+    for (const auto& state : autoConfigureStates_)
+    {
+        if (!state->unchanged())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Mhwd::isKnownDevice(const Device& device) const
+{
+    if (arguments_.FORCE || autoConfigureStates_.empty())
+    {
+        return false;
+    }
+
+    for (const auto& state : autoConfigureStates_)
+    {
+        if (!state->knowsDevice(device))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Mhwd::saveAutoConfigureStates(const std::vector<MHWD::BUS>& busTypes) const
+{
+    if (autoConfigureStates_.empty() || !isUserRoot())
+    {
+        return;
+    }
+
+    std::shared_ptr<const Data> data{installers_.front()->dataStore().snapshot()};
+    std::vector<std::shared_ptr<Device>> devices;
+    for (const auto& busType : busTypes)
+    {
+        const auto& busDevices = (MHWD::BUS::USB == busType) ? data->USBDevices : data->PCIDevices;
+        devices.insert(devices.end(), busDevices.begin(), busDevices.end());
+    }
+
+    for (const auto& state : autoConfigureStates_)
+    {
+        if (!state->write(devices))
+        {
+            consoleWriter_.printWarning("failed to save auto-configure state!");
+        }
+    }
+}
+
+int Mhwd::evaluateFleet(const AutoConfigure& autoConfigure) const
+{
+    try
+    {
+        const std::vector<std::string> profilePaths{Fleet::expandProfilePaths(fleetPaths_)};
+        const Data database{environment_, {}, {}};
+        for (const auto& invalidConfig : database.invalidConfigs)
+        {
+            consoleWriter_.printWarning("config '" + invalidConfig->configPath_ + "' is invalid!");
+        }
+
+        int ret = 0;
+        Fleet{database, autoConfigure}.evaluate(profilePaths, std::thread::hardware_concurrency(),
+                [this, &ret](const Fleet::Result& result) {
+                    consoleWriter_.printFleetResult(result);
+                    if (!result.error.empty())
+                    {
+                        ret = 1;
+                    }
+                });
+        return ret;
+    }
+    catch(const std::runtime_error& e)
+    {
+        consoleWriter_.printError(e.what());
+        return 1;
+    }
+}
+
+void Mhwd::setDatabaseDir(const std::string& dbDir)
+{
+    environment_.PCIConfigDir = dbDir + "/pci";
+    environment_.USBConfigDir = dbDir + "/usb";
+}
+
+void Mhwd::setLocalDir(const std::string& localDir)
+{
+    environment_.PCIDatabaseDir = localDir + "/pci";
+    environment_.USBDatabaseDir = localDir + "/usb";
+    environment_.autoConfigureStatePath = localDir + "/autoconfigure";
+    environment_.metricsPath = localDir + "/metrics";
+}
+
 std::string Mhwd::gatherConfigContent(const std::vector<std::shared_ptr<Config>> & configuration) const
 {
     std::string config;
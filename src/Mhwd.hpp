@@ -36,14 +36,18 @@
 #include <string>
 #include <vector>
 
+#include "AutoConfigure.hpp"
+#include "AutoConfigureState.hpp"
 #include "Config.hpp"
 #include "const.h"
 #include "ConsoleWriter.hpp"
 #include "Data.hpp"
 #include "Device.hpp"
 #include "Enums.hpp"
+#include "Installer.hpp"
+#include "MetricsStore.hpp"
+#include "Plan.hpp"
 #include "vita/string.hpp"
-#include "Transaction.hpp"
 
 class Mhwd
 {
@@ -68,38 +72,81 @@ private:
         bool LIST_HARDWARE = false;
         bool CUSTOM_INSTALL = false;
         bool AUTOCONFIGURE = false;
+        bool PROFILE = false;
+        bool DUMP_FIXTURE = false;
+        bool MODALIAS = false;
+        bool XORG_DEVICES = false;
+        bool GPU_STATUS = false;
+        bool GPU_CHECK = false;
+        bool GPU_MODULES = false;
+        bool KERNEL = false;
+        bool PLAN = false;
+        bool APPLY_PLAN = false;
+        bool FLEET = false;
+        bool SYNC = false;
+        bool NOSYNC = false;
+        bool FULL_PROBE = false;
+        bool METRICS = false;
     } arguments_;
     std::shared_ptr<Config> config_;
-    Data data_;
+    Data::Environment environment_;
+    std::vector<std::string> roots_;
+    long syncMaxAge_ = MHWD_PM_SYNC_MAX_AGE;
+    std::vector<std::unique_ptr<Installer>> installers_;
+    std::vector<std::unique_ptr<AutoConfigureState>> autoConfigureStates_;
+    std::string fixturePath_;
+    std::string dumpFixturePath_;
+    std::vector<std::string> modaliasModules_;
+    std::string modaliasFile_;
+    std::vector<std::string> xorgArguments_;
+    std::vector<std::string> gpuModules_;
+    std::vector<std::string> gpuBlacklistedModules_;
+    std::string kernelAction_;
+    std::vector<std::string> kernels_;
+    std::string planPath_;
+    std::vector<std::string> fleetPaths_;
+    std::string metricsTextfile_;
+    // One store per installer, below the root its samples were taken for
+    std::vector<std::shared_ptr<MetricsStore>> metrics_;
     ConsoleWriter consoleWriter_;
     std::vector<std::string> configs_;
     std::string version_, year_;
 
-    bool performTransaction(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE type);
+    int execute(int argc, char *argv[]);
+    bool performTransactions(const std::vector<std::shared_ptr<Config>>& configs,
+            MHWD::TRANSACTIONTYPE type, bool skipInstalled = false);
+    bool planTransactions(const Data& data, const std::vector<std::shared_ptr<Config>>& configs,
+            MHWD::TRANSACTIONTYPE type, Plan& plan);
+    // Runs the plans with a transaction log and saves the metrics of the transaction
+    bool executePlans(const std::vector<Plan>& plans);
+    bool runPlans(const std::vector<Plan>& plans);
+    bool applyPlan();
     bool isUserRoot() const;
-    std::vector<std::string> checkEnvironment() const;
+    std::vector<Data::Environment> getEnvironments() const;
+    bool needsSync(const Data::Environment& environment) const;
+    std::vector<std::string> checkEnvironment(const Data::Environment& environment) const;
+    bool createInstallers();
 
-    std::shared_ptr<Config> getInstalledConfig(const std::string& configName, const std::string& configType);
-    std::shared_ptr<Config> getDatabaseConfig(const std::string& configName, const std::string& configType);
-    std::shared_ptr<Config> getAvailableConfig(const std::string& configName, const std::string& configType);
-
-    MHWD::STATUS performTransaction(const Transaction& transaction);
     bool proceedWithInstallation(const std::string& input) const;
-
-    bool copyDirectory(const std::string& source, const std::string& destination);
-    bool copyFile(const std::string& source, const std::string destination, const mode_t mode =
-            S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IROTH);
-    bool removeDirectory(const std::string& directory);
     bool dirExists(const std::string& path) const;
-    bool createDir(const std::string& path, const mode_t mode =
-            S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IROTH | S_IXGRP | S_IXOTH);
 
-    MHWD::STATUS installConfig(std::shared_ptr<Config> config);
-    MHWD::STATUS uninstallConfig(Config *config);
-    bool runScript(std::shared_ptr<Config> config, MHWD::TRANSACTIONTYPE operationType);
     void tryToParseCmdLineOptions(int argc, char* argv[], bool& autoConfigureNonFreeDriver,
-            std::string& operationType, std::string& autoConfigureClassID);
+            MHWD::BUS& operationType, std::vector<MHWD::BUS>& autoConfigureBusTypes,
+            std::vector<std::string>& autoConfigureClassIDs);
     bool optionsDontInterfereWithEachOther() const;
+    int printModaliasIDs() const;
+    int writeXorgDevices() const;
+    int manageGpu() const;
+    int planKernels() const;
+    int exportMetrics() const;
+    void loadAutoConfigureStates(const std::vector<MHWD::BUS>& busTypes,
+            const std::vector<std::string>& classIDs, bool nonFreeDriver);
+    bool autoConfigureUnchanged() const;
+    bool isKnownDevice(const Device& device) const;
+    void saveAutoConfigureStates(const std::vector<MHWD::BUS>& busTypes) const;
+    int evaluateFleet(const AutoConfigure& autoConfigure) const;
+    void setDatabaseDir(const std::string& dbDir);
+    void setLocalDir(const std::string& localDir);
     std::string gatherConfigContent(const std::vector<std::shared_ptr<Config>> & config) const;
 };
 
@@ -0,0 +1,75 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef OUTPUTSINK_HPP_
+#define OUTPUTSINK_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Device.hpp"
+#include "Enums.hpp"
+#include "Fleet.hpp"
+#include "GpuStatus.hpp"
+#include "ModaliasIndex.hpp"
+#include "Plan.hpp"
+#include "Profiler.hpp"
+
+/*
+ * Destination of everything ConsoleWriter prints. Each listing is handed
+ * over as a whole, so a sink can stream its own records straight to its
+ * output instead of receiving preformatted text.
+ */
+class OutputSink
+{
+public:
+    virtual ~OutputSink() = default;
+
+    virtual void status(const std::string& statusMsg) = 0;
+    virtual void error(const std::string& errorMsg) = 0;
+    virtual void warning(const std::string& warningMsg) = 0;
+    virtual void message(MHWD::MESSAGETYPE type, const std::string& msg) = 0;
+    virtual void devices(const std::vector<std::shared_ptr<Device>>& devices,
+            MHWD::BUS typeOfDevice) = 0;
+    virtual void configs(const std::vector<std::shared_ptr<Config>>& configs,
+            const std::string& header) = 0;
+    // The configs available for one device
+    virtual void deviceConfigs(const Device& device, MHWD::BUS typeOfDevice) = 0;
+    virtual void availableConfigsInDetail(MHWD::BUS deviceType,
+            const std::vector<std::shared_ptr<Device>>& devices) = 0;
+    virtual void installedConfigs(MHWD::BUS deviceType,
+            const std::vector<std::shared_ptr<Config>>& installedConfigs) = 0;
+    virtual void configDetails(const Config& config) = 0;
+    virtual void plan(const Plan& plan) = 0;
+    virtual void fleetResult(const Fleet::Result& result) = 0;
+    virtual void gpuStatus(const GpuStatus& status) = 0;
+    virtual void modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules) = 0;
+    virtual void profile(const Profiler& profiler) = 0;
+    virtual void flush() = 0;
+};
+
+#endif /* OUTPUTSINK_HPP_ */
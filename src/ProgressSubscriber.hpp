@@ -0,0 +1,72 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PROGRESSSUBSCRIBER_HPP_
+#define PROGRESSSUBSCRIBER_HPP_
+
+#include <chrono>
+#include <string>
+
+#include "Enums.hpp"
+
+/*
+ * Gets the progress of plan execution as structured events, for front
+ * ends that want more than the printed text. ConsoleWriter hands events
+ * over one at a time, in the order they happened.
+ */
+class ProgressSubscriber
+{
+public:
+    struct Event
+    {
+        MHWD::MESSAGETYPE type = MHWD::MESSAGETYPE::CONSOLE_OUTPUT;
+        // Monotonic, only differences between events mean something
+        std::chrono::steady_clock::time_point time;
+        // Root label, empty when mhwd works on one system
+        std::string label;
+        // Empty for output outside of a step, like the package download
+        std::string configName;
+        // Position in the plan counting from 1, 0 outside of a step
+        unsigned int step = 0;
+        unsigned int steps = 0;
+        // *_END only: SUCCESS, or why the step failed
+        MHWD::STATUS status = MHWD::STATUS::SUCCESS;
+        // *_END only: time since the *_START of the step
+        std::chrono::steady_clock::duration duration {};
+        // CONSOLE_OUTPUT only: one line of script or pacman output
+        std::string text;
+        // CONSOLE_OUTPUT only: the line came from stderr
+        bool fromStderr = false;
+        // CONSOLE_OUTPUT only: if not 0, text only says that many lines were
+        // dropped because the reader fell behind
+        unsigned long droppedLines = 0;
+    };
+
+    virtual ~ProgressSubscriber() = default;
+
+    virtual void event(const Event& event) = 0;
+};
+
+#endif /* PROGRESSSUBSCRIBER_HPP_ */
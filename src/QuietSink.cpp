@@ -0,0 +1,63 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "QuietSink.hpp"
+
+#include <string>
+
+QuietSink::QuietSink(std::ostream& out, std::ostream& err)
+    : out_(out), err_(err)
+{}
+
+void QuietSink::error(const std::string& errorMsg)
+{
+    err_ << "Error: " << errorMsg << '\n';
+}
+
+void QuietSink::plan(const Plan& plan)
+{
+    plan.write(out_);
+}
+
+void QuietSink::fleetResult(const Fleet::Result& result)
+{
+    Fleet::write(out_, result);
+}
+
+void QuietSink::gpuStatus(const GpuStatus& status)
+{
+    GpuStatus::write(out_, status);
+}
+
+void QuietSink::modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules)
+{
+    ModaliasIndex::write(out_, modules);
+}
+
+void QuietSink::flush()
+{
+    out_.flush();
+    err_.flush();
+}
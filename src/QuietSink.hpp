@@ -0,0 +1,67 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef QUIETSINK_HPP_
+#define QUIETSINK_HPP_
+
+#include <ostream>
+#include <string>
+
+#include "OutputSink.hpp"
+
+/*
+ * Drops everything but errors, which still go to the given stream, and
+ * plans, which are the result rather than progress.
+ */
+class QuietSink : public OutputSink
+{
+public:
+    QuietSink(std::ostream& out, std::ostream& err);
+
+    void status(const std::string&) override {}
+    void error(const std::string& errorMsg) override;
+    void warning(const std::string&) override {}
+    void message(MHWD::MESSAGETYPE, const std::string&) override {}
+    void devices(const std::vector<std::shared_ptr<Device>>&, MHWD::BUS) override {}
+    void configs(const std::vector<std::shared_ptr<Config>>&, const std::string&) override {}
+    void deviceConfigs(const Device&, MHWD::BUS) override {}
+    void availableConfigsInDetail(MHWD::BUS,
+            const std::vector<std::shared_ptr<Device>>&) override {}
+    void installedConfigs(MHWD::BUS,
+            const std::vector<std::shared_ptr<Config>>&) override {}
+    void configDetails(const Config&) override {}
+    void plan(const Plan& plan) override;
+    void fleetResult(const Fleet::Result& result) override;
+    void gpuStatus(const GpuStatus& status) override;
+    void modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules) override;
+    void profile(const Profiler&) override {}
+    void flush() override;
+
+private:
+    std::ostream& out_;
+    std::ostream& err_;
+};
+
+#endif /* QUIETSINK_HPP_ */
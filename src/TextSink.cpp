@@ -0,0 +1,311 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextSink.hpp"
+
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TextSink::TextSink(std::ostream& out, bool colored)
+    : out_(out),
+      colorReset_(colored ? "\033[m" : ""),
+      redMessageColor_(colored ? "\033[1m\033[31m" : ""),
+      textOutputColor_(colored ? "\033[0;32m" : "")
+{}
+
+void TextSink::status(const std::string& statusMsg)
+{
+    out_ << redMessageColor_ << "> " << colorReset_ << statusMsg << '\n';
+}
+
+void TextSink::error(const std::string& errorMsg)
+{
+    out_ << redMessageColor_ << "Error: " << colorReset_ << errorMsg << '\n';
+}
+
+void TextSink::warning(const std::string& warningMsg)
+{
+    out_ << redMessageColor_ << "Warning: " << colorReset_ << warningMsg << '\n';
+}
+
+void TextSink::message(MHWD::MESSAGETYPE type, const std::string& msg)
+{
+    switch(type)
+    {
+        case MHWD::MESSAGETYPE::CONSOLE_OUTPUT:
+            out_ << textOutputColor_ << msg << colorReset_;
+            break;
+        case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_START:
+            status("Installing dependency " + msg + "...");
+            break;
+        case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END:
+            status("Successfully installed dependency " + msg);
+            break;
+        case MHWD::MESSAGETYPE::INSTALL_START:
+            status("Installing " + msg + "...");
+            break;
+        case MHWD::MESSAGETYPE::INSTALL_END:
+            status("Successfully installed " + msg);
+            break;
+        case MHWD::MESSAGETYPE::REMOVE_START:
+            status("Removing " + msg + "...");
+            break;
+        case MHWD::MESSAGETYPE::REMOVE_END:
+            status("Successfully removed " + msg);
+            break;
+        default:
+            error("You shouldn't see this?! Unknown message type!");
+            break;
+    }
+}
+
+void TextSink::devices(const std::vector<std::shared_ptr<Device>>& devices,
+        MHWD::BUS typeOfDevice)
+{
+    if (devices.empty())
+    {
+        warning(std::string{"No "} + MHWD::busName(typeOfDevice) + " devices found!");
+    }
+    else
+    {
+        status(std::string{MHWD::busName(typeOfDevice)} + " devices:");
+        printLine();
+        out_ << std::setw(30) << "TYPE"
+                << std::setw(15) << "BUS"
+                << std::setw(8) << "CLASS"
+                << std::setw(8) << "VENDOR"
+                << std::setw(8) << "DEVICE"
+                << std::setw(10) << "CONFIGS" << '\n';
+        printLine();
+        for (const auto& device : devices)
+        {
+            out_ << std::setw(30) << device->className_
+                    << std::setw(15) << device->sysfsBusID_
+                    << std::setw(8) << device->classID_
+                    << std::setw(8) << device->vendorID_
+                    << std::setw(8) << device->deviceID_
+                    << std::setw(10) << device->availableConfigs_.size() << '\n';
+        }
+        out_ << "\n\n";
+    }
+}
+
+void TextSink::configs(const std::vector<std::shared_ptr<Config>>& configs,
+        const std::string& header)
+{
+    status(header);
+    printLine();
+    out_ << std::setw(22) << "NAME"
+            << std::setw(22) << "VERSION"
+            << std::setw(20) << "FREEDRIVER"
+            << std::setw(15) << "TYPE" << '\n';
+    printLine();
+    for (const auto& config : configs)
+    {
+        out_ << std::setw(22) << config->name_
+                << std::setw(22) << config->version_
+                << std::setw(20) << std::boolalpha << config->freedriver_
+                << std::setw(15) << MHWD::busName(config->type_) << '\n';
+    }
+    out_ << "\n\n";
+}
+
+void TextSink::deviceConfigs(const Device& device, MHWD::BUS)
+{
+    configs(device.availableConfigs_, device.sysfsBusID_ + " (" + device.classID_ + ":"
+            + device.vendorID_ + ":" + device.deviceID_ + ") " + device.className_ + " "
+            + device.vendorName_ + ":");
+}
+
+void TextSink::availableConfigsInDetail(MHWD::BUS deviceType,
+        const std::vector<std::shared_ptr<Device>>& devices)
+{
+    bool configFound = false;
+
+    for (const auto& device : devices)
+    {
+        if (device->availableConfigs_.empty() && device->installedConfigs_.empty())
+        {
+            continue;
+        }
+        else
+        {
+            configFound = true;
+
+            printLine();
+            out_ << redMessageColor_ << "> " << colorReset_
+                    << MHWD::busName(deviceType) << " Device: " << device->sysfsID_ << " (" << device->classID_
+                    << ":" << device->vendorID_ << ":" << device->deviceID_ << ")\n";
+            out_ << "  " << device->className_
+                    << " " << device->vendorName_
+                    << " " << device->deviceName_ << '\n';
+            printLine();
+            if (!device->installedConfigs_.empty())
+            {
+                out_ << "  > INSTALLED:\n\n";
+                for (auto&& installedConfig : device->installedConfigs_)
+                {
+                    configDetails(*installedConfig);
+                }
+                out_ << "\n\n";
+            }
+            if (!device->availableConfigs_.empty())
+            {
+                out_ << "  > AVAILABLE:\n\n";
+                for (auto&& availableConfig : device->availableConfigs_)
+                {
+                    configDetails(*availableConfig);
+                }
+                out_ << '\n';
+            }
+        }
+    }
+
+    if (!configFound)
+    {
+        warning(std::string{"no configs for "} + MHWD::busName(deviceType) + " devices found!");
+    }
+}
+
+void TextSink::installedConfigs(MHWD::BUS deviceType,
+        const std::vector<std::shared_ptr<Config>>& installedConfigs)
+{
+    if (installedConfigs.empty())
+    {
+        warning(std::string{"no installed configs for "} + MHWD::busName(deviceType) + " devices found!");
+    }
+    else
+    {
+        for (const auto& config : installedConfigs)
+        {
+            configDetails(*config);
+        }
+        out_ << '\n';
+    }
+}
+
+void TextSink::configDetails(const Config& config)
+{
+    out_ << "   NAME:\t" << config.name_
+            << "\n   ATTACHED:\t" << MHWD::busName(config.type_)
+            << "\n   VERSION:\t" << config.version_
+            << "\n   INFO:\t" << (config.info_.empty() ? "-" : config.info_)
+            << "\n   PRIORITY:\t" << config.priority_
+            << "\n   FREEDRIVER:\t" << std::boolalpha << config.freedriver_
+            << "\n   DEPENDS:\t";
+    printList(config.dependencies_);
+    out_ << "\n   CONFLICTS:\t";
+    printList(config.conflicts_);
+    out_ << "\n   CLASSIDS:\t";
+    for (const auto& hwd : config.hwdIDs_)
+    {
+        for (const auto& classID : hwd.classIDs)
+        {
+            out_ << classID << " ";
+        }
+    }
+    out_ << "\n   VENDORIDS:\t";
+    for (const auto& hwd : config.hwdIDs_)
+    {
+        for (const auto& vendorID : hwd.vendorIDs)
+        {
+            out_ << vendorID << " ";
+        }
+    }
+    out_ << "\n\n";
+}
+
+void TextSink::plan(const Plan& plan)
+{
+    plan.write(out_);
+}
+
+void TextSink::fleetResult(const Fleet::Result& result)
+{
+    Fleet::write(out_, result);
+}
+
+void TextSink::gpuStatus(const GpuStatus& status)
+{
+    GpuStatus::write(out_, status);
+}
+
+void TextSink::modaliasIDs(const std::vector<ModaliasIndex::IDs>& modules)
+{
+    ModaliasIndex::write(out_, modules);
+}
+
+void TextSink::profile(const Profiler& profiler)
+{
+    status("Profile:");
+    printLine();
+    out_ << std::setw(40) << "PHASE"
+            << std::setw(10) << "CALLS"
+            << std::setw(14) << "TOTAL ms" << '\n';
+    printLine();
+    for (const auto& phase : profiler.phases())
+    {
+        // Formatted aside, so out_ keeps its own float format
+        std::ostringstream milliseconds;
+        milliseconds << std::fixed << std::setprecision(3) << phase.milliseconds;
+        out_ << std::setw(40) << phase.name
+                << std::setw(10) << phase.calls
+                << std::setw(14) << milliseconds.str()
+                << '\n';
+    }
+    printLine();
+    for (int counter = 0; counter < static_cast<int>(Profiler::COUNTER::COUNT); ++counter)
+    {
+        const auto type = static_cast<Profiler::COUNTER>(counter);
+        out_ << std::setw(40) << Profiler::counterName(type)
+                << std::setw(10) << profiler.counter(type) << '\n';
+    }
+    out_ << '\n';
+}
+
+void TextSink::flush()
+{
+    out_.flush();
+}
+
+void TextSink::printLine()
+{
+    out_ << std::string(80, '-') << '\n';
+}
+
+void TextSink::printList(const std::vector<std::string>& values)
+{
+    if (values.empty())
+    {
+        out_ << "-";
+    }
+    for (const auto& value : values)
+    {
+        out_ << value << " ";
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TransactionLog.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // Buffered lines are written once they reach this size, or when a step ends
+    constexpr std::size_t WRITE_SIZE = 64 * 1024;
+
+    std::string localTime(const char* format)
+    {
+        const std::time_t now = std::time(nullptr);
+        struct tm local;
+        char text[64];
+        localtime_r(&now, &local);
+        std::strftime(text, sizeof(text), format, &local);
+        return text;
+    }
+}
+
+TransactionLog::TransactionLog(const std::string& directory, std::size_t maxFiles)
+    : start_(std::chrono::steady_clock::now())
+{
+    mkdir(directory.c_str(), S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+    path_ = directory + "/mhwd-" + localTime("%Y%m%d-%H%M%S") + "-" + std::to_string(getpid())
+            + ".log";
+    fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+            S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    removeOldLogs(directory, maxFiles);
+    buffer_.reserve(WRITE_SIZE * 2);
+    buffer_ += "# mhwd transaction log, started " + localTime("%Y-%m-%d %H:%M:%S") + "\n";
+}
+
+TransactionLog::~TransactionLog()
+{
+    if (fd_ >= 0)
+    {
+        writeBuffer();
+        close(fd_);
+    }
+}
+
+bool TransactionLog::isOpen() const
+{
+    return fd_ >= 0;
+}
+
+const std::string& TransactionLog::path() const
+{
+    return path_;
+}
+
+void TransactionLog::event(const Event& event)
+{
+    if (fd_ < 0)
+    {
+        return;
+    }
+
+    char elapsed[32];
+    std::snprintf(elapsed, sizeof(elapsed), "%9.3f ",
+            std::chrono::duration<double>(event.time - start_).count());
+    std::string line{elapsed};
+
+    if (MHWD::MESSAGETYPE::CONSOLE_OUTPUT == event.type)
+    {
+        line += event.fromStderr ? "err  " : "out  ";
+    }
+    else
+    {
+        line += "---- ";
+    }
+    if (!event.label.empty())
+    {
+        line += "[" + event.label + "] ";
+    }
+
+    bool stepEnded = false;
+    switch (event.type)
+    {
+        case MHWD::MESSAGETYPE::CONSOLE_OUTPUT:
+            line += event.text;
+            break;
+        case MHWD::MESSAGETYPE::INSTALLDEPENDENCY_END:
+        case MHWD::MESSAGETYPE::INSTALL_END:
+        case MHWD::MESSAGETYPE::REMOVE_END:
+        {
+            char duration[32];
+            std::snprintf(duration, sizeof(duration), "%.3fs",
+                    std::chrono::duration<double>(event.duration).count());
+            line += std::string{MHWD::messageTypeName(event.type)} + " " + event.configName + " ("
+                    + std::to_string(event.step) + "/" + std::to_string(event.steps) + ") "
+                    + MHWD::statusName(event.status) + ", " + duration + "\n";
+            stepEnded = true;
+            break;
+        }
+        default:
+            line += std::string{MHWD::messageTypeName(event.type)} + " " + event.configName + " ("
+                    + std::to_string(event.step) + "/" + std::to_string(event.steps) + ")\n";
+            break;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_ += line;
+    if (stepEnded || (buffer_.size() >= WRITE_SIZE))
+    {
+        writeBuffer();
+    }
+}
+
+void TransactionLog::removeOldLogs(const std::string& directory, std::size_t maxFiles) const
+{
+    DIR *dir = opendir(directory.c_str());
+    if (nullptr == dir)
+    {
+        return;
+    }
+
+    // Names start with the time, so they sort oldest first
+    std::vector<std::string> logs;
+    struct dirent *entry;
+    while (nullptr != (entry = readdir(dir)))
+    {
+        const std::string name{entry->d_name};
+        if ((name.compare(0, 5, "mhwd-") == 0) && (name.size() > 4)
+                && (name.compare(name.size() - 4, 4, ".log") == 0))
+        {
+            logs.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    std::sort(logs.begin(), logs.end());
+    for (std::size_t i = 0; i + maxFiles < logs.size(); ++i)
+    {
+        unlink((directory + "/" + logs[i]).c_str());
+    }
+}
+
+void TransactionLog::writeBuffer()
+{
+    std::size_t written = 0;
+    while (written < buffer_.size())
+    {
+        const ssize_t result = write(fd_, buffer_.data() + written, buffer_.size() - written);
+        if (result >= 0)
+        {
+            written += result;
+        }
+        else if (EINTR != errno)
+        {
+            break;
+        }
+    }
+    buffer_.clear();
+}
@@ -0,0 +1,65 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TRANSACTIONLOG_HPP_
+#define TRANSACTIONLOG_HPP_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "ProgressSubscriber.hpp"
+
+/*
+ * Keeps everything a transaction printed, script stdout and stderr apart,
+ * in its own file below /var/log/mhwd. Lines are collected in memory and
+ * written in large blocks; nothing reaches the disk in between, so the
+ * log never slows down a script. Installers of all roots share one log.
+ */
+class TransactionLog : public ProgressSubscriber
+{
+public:
+    // Opens a new log named after the current time, keeping only the newest maxFiles logs
+    TransactionLog(const std::string& directory, std::size_t maxFiles);
+    ~TransactionLog();
+    TransactionLog(const TransactionLog&) = delete;
+    TransactionLog& operator=(const TransactionLog&) = delete;
+
+    bool isOpen() const;
+    const std::string& path() const;
+    void event(const Event& event) override;
+
+private:
+    void removeOldLogs(const std::string& directory, std::size_t maxFiles) const;
+    void writeBuffer();
+
+    std::string path_;
+    int fd_ = -1;
+    std::chrono::steady_clock::time_point start_;
+    std::mutex mutex_;
+    std::string buffer_;
+};
+
+#endif /* TRANSACTIONLOG_HPP_ */
@@ -0,0 +1,123 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "EventQueue.hpp"
+#include "EventStream.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    constexpr unsigned long LINES = 20000;
+
+    // Everything the reader can take in right now
+    std::string readAvailable(int fd)
+    {
+        std::string data;
+        char buffer[4096];
+        ssize_t size;
+        while ((size = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            data.append(buffer, size);
+        }
+        return data;
+    }
+
+    unsigned long countRecords(const std::string& data, const std::string& type)
+    {
+        unsigned long count = 0;
+        for (std::size_t pos = data.find(type); std::string::npos != pos; pos = data.find(type, pos + 1))
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    unsigned long droppedEvents(const std::string& data)
+    {
+        unsigned long count = 0;
+        const std::string key{"\"type\":\"dropped\",\"time_us\":"};
+        for (std::size_t pos = data.find(key); std::string::npos != pos; pos = data.find(key, pos + 1))
+        {
+            count += std::strtoul(data.c_str() + data.find("\"count\":", pos) + 8, nullptr, 10);
+        }
+        return count;
+    }
+}
+
+int main()
+{
+    int fds[2];
+    CHECK(0 == pipe(fds));
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    std::shared_ptr<EventStream> stream{new EventStream(fds[1], std::chrono::milliseconds{200})};
+    EventQueue queue([&stream](const std::deque<ProgressSubscriber::Event>& events) {
+                for (const auto& event : events)
+                {
+                    stream->event(event);
+                }
+            }, 1000);
+
+    // Nobody reads: pushing and waiting must not hang, the queue must not grow
+    const auto start = std::chrono::steady_clock::now();
+    ProgressSubscriber::Event output;
+    output.text = std::string(100, 'x') + "\n";
+    for (unsigned long i = 0; i < LINES; ++i)
+    {
+        output.time = std::chrono::steady_clock::now();
+        queue.push(output);
+    }
+    queue.wait();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds{5});
+
+    std::string data{readAvailable(fds[0])};
+    CHECK(countRecords(data, "\"type\":\"output\"") < LINES);
+
+    // Once the reader is back, it learns how much it missed before the next event
+    ProgressSubscriber::Event installStart;
+    installStart.type = MHWD::MESSAGETYPE::INSTALL_START;
+    installStart.time = std::chrono::steady_clock::now();
+    queue.push(installStart);
+    queue.wait();
+    data += readAvailable(fds[0]);
+
+    const std::size_t dropped = data.rfind("\"type\":\"dropped\"");
+    CHECK(std::string::npos != dropped);
+    CHECK(dropped < data.find("\"type\":\"install_start\""));
+    CHECK(countRecords(data, "\"type\":\"output\"") + droppedEvents(data) == LINES);
+    CHECK('\n' == data.back());
+
+    close(fds[0]);
+    close(fds[1]);
+    return Test::result();
+}
@@ -0,0 +1,150 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Data.hpp"
+#include "Device.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    std::string writeConfig(const std::string& dir, const std::string& name,
+            const std::string& version, const std::string& vendorIDs)
+    {
+        const std::string path{dir + "/" + name + "/MHWDCONFIG"};
+        Test::writeFile(path, "NAME=\"" + name + "\"\nVERSION=\"" + version + "\"\n"
+                "FREEDRIVER=\"true\"\nCLASSIDS=\"0300 0C03\"\nVENDORIDS=\"" + vendorIDs + "\"\n"
+                "DEVICEIDS=\"*\"\n");
+        return path;
+    }
+
+    std::shared_ptr<Config> readConfig(const std::string& path, MHWD::BUS type)
+    {
+        std::shared_ptr<Config> config{new Config(path, type)};
+        CHECK(config->readConfigFile(path));
+        return config;
+    }
+
+    std::shared_ptr<Device> device(MHWD::BUS type, const std::string& classID,
+            const std::string& vendorID)
+    {
+        std::shared_ptr<Device> newDevice{new Device()};
+        newDevice->type_ = type;
+        newDevice->classID_ = classID;
+        newDevice->vendorID_ = vendorID;
+        newDevice->deviceID_ = "1234";
+        return newDevice;
+    }
+
+    // Sorted "name version" of configs: the order they are added in doesn't matter
+    std::vector<std::string> names(const std::vector<std::shared_ptr<Config>>& configs)
+    {
+        std::vector<std::string> configNames;
+        for (const auto& config : configs)
+        {
+            configNames.push_back(config->name_ + " " + config->version_);
+        }
+        std::sort(configNames.begin(), configNames.end());
+        return configNames;
+    }
+
+    // The incremental updates leave data as reading the local database again would
+    void checkSameAsFullUpdate(const Data& data)
+    {
+        Data full{data};
+        full.updateInstalledConfigData();
+
+        CHECK(names(data.installedPCIConfigs) == names(full.installedPCIConfigs));
+        CHECK(names(data.installedUSBConfigs) == names(full.installedUSBConfigs));
+        for (std::size_t i = 0; i < data.PCIDevices.size(); ++i)
+        {
+            CHECK(names(data.PCIDevices[i]->installedConfigs_)
+                    == names(full.PCIDevices[i]->installedConfigs_));
+        }
+        for (std::size_t i = 0; i < data.USBDevices.size(); ++i)
+        {
+            CHECK(names(data.USBDevices[i]->installedConfigs_)
+                    == names(full.USBDevices[i]->installedConfigs_));
+        }
+    }
+}
+
+int main()
+{
+    const std::string root{Test::temporaryDirectory()};
+    const std::string localPCI{root + "/local/pci"};
+    const std::string localUSB{root + "/local/usb"};
+    Test::makeDirectories(root + "/db/pci");
+    Test::makeDirectories(root + "/db/usb");
+    Test::makeDirectories(localPCI);
+    Test::makeDirectories(localUSB);
+
+    Data::Environment environment;
+    environment.PMRootPath = root;
+    environment.PCIConfigDir = root + "/db/pci";
+    environment.USBConfigDir = root + "/db/usb";
+    environment.PCIDatabaseDir = localPCI;
+    environment.USBDatabaseDir = localUSB;
+
+    Data data{environment,
+            {device(MHWD::BUS::PCI, "0300", "10de"), device(MHWD::BUS::PCI, "0300", "8086")},
+            {device(MHWD::BUS::USB, "0c03", "8086")}};
+    CHECK(data.installedPCIConfigs.empty());
+
+    // Installs copy the config into the local database, then register it
+    data.addInstalledConfig(readConfig(writeConfig(localPCI, "any", "1", "*"), MHWD::BUS::PCI));
+    data.addInstalledConfig(readConfig(writeConfig(localPCI, "nvidia", "1", "10de"),
+            MHWD::BUS::PCI));
+    data.addInstalledConfig(readConfig(writeConfig(localUSB, "usb", "1", "8086"),
+            MHWD::BUS::USB));
+    CHECK(2 == data.installedPCIConfigs.size());
+    CHECK(2 == data.PCIDevices[0]->installedConfigs_.size());
+    CHECK(1 == data.PCIDevices[1]->installedConfigs_.size());
+    CHECK(1 == data.USBDevices[0]->installedConfigs_.size());
+    checkSameAsFullUpdate(data);
+
+    // A reinstall replaces the older version instead of adding a second one
+    data.addInstalledConfig(readConfig(writeConfig(localPCI, "nvidia", "2", "10de"),
+            MHWD::BUS::PCI));
+    CHECK(2 == data.installedPCIConfigs.size());
+    CHECK("2" == data.getInstalledConfig("nvidia", MHWD::BUS::PCI)->version_);
+    checkSameAsFullUpdate(data);
+
+    // Removals delete the local copy, then unregister it
+    const std::shared_ptr<Config> any{data.getInstalledConfig("any", MHWD::BUS::PCI)};
+    Test::removeDirectory(any->basePath_);
+    data.removeInstalledConfig(any);
+    CHECK(nullptr == data.getInstalledConfig("any", MHWD::BUS::PCI));
+    CHECK(data.PCIDevices[1]->installedConfigs_.empty());
+    checkSameAsFullUpdate(data);
+
+    Test::removeDirectory(root);
+    return Test::result();
+}
@@ -0,0 +1,127 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "KernelPlanner.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    typedef std::vector<std::string> Packages;
+
+    // A pacman that only answers -Slq, with the packages of the sync databases
+    void writePacman(const std::string& directory, const Packages& available)
+    {
+        std::string script{"#!/bin/sh\n"};
+        for (const auto& package : available)
+        {
+            script += "echo " + package + "\n";
+        }
+        Test::writeFile(directory + "/pacman", script);
+        chmod((directory + "/pacman").c_str(), S_IRWXU);
+        setenv("PATH", (directory + ":" + getenv("PATH")).c_str(), 1);
+    }
+
+    void writeLocalDatabase(const std::string& root, const Packages& installed)
+    {
+        for (const auto& package : installed)
+        {
+            Test::writeFile(root + "/var/lib/pacman/local/" + package + "-1.0-1/desc", package);
+        }
+    }
+
+    template<typename Function>
+    bool throws(Function function)
+    {
+        try
+        {
+            function();
+        }
+        catch(const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    CHECK(KernelPlanner::isKernel("linux61"));
+    CHECK(KernelPlanner::isKernel("linux610"));
+    CHECK(KernelPlanner::isKernel("linux61-rt"));
+    CHECK(KernelPlanner::isKernel("linux610-rt"));
+    CHECK(!KernelPlanner::isKernel("linux"));
+    CHECK(!KernelPlanner::isKernel("linux6"));
+    CHECK(!KernelPlanner::isKernel("linux6100"));
+    CHECK(!KernelPlanner::isKernel("linux-rt"));
+    CHECK(!KernelPlanner::isKernel("linux61rt"));
+    CHECK(!KernelPlanner::isKernel("linux61-nvidia"));
+    CHECK(!KernelPlanner::isKernel("linux-lts"));
+    CHECK(!KernelPlanner::isKernel("linux6a"));
+
+    const std::string root{Test::temporaryDirectory()};
+    writeLocalDatabase(root, {"linux61", "linux61-nvidia", "linux61-rtl8821cu",
+            "linux61-virtualbox-host-modules", "linux61-rt", "linux61-rt-nvidia", "linux610",
+            "linux610-nvidia", "nvidia-utils"});
+    writePacman(root + "/bin", {"linux61", "linux61-nvidia", "linux610", "linux610-nvidia",
+            "linux66", "linux66-nvidia", "linux66-rtl8821cu", "linux66-rt", "linux66-rt-nvidia",
+            "linux-firmware", "nvidia-utils"});
+    const KernelPlanner planner{root, "/etc/pacman.conf"};
+
+    CHECK((planner.installedKernels() == Packages{"linux61", "linux61-rt", "linux610"}));
+    CHECK((planner.availableKernels() == Packages{"linux61", "linux610", "linux66", "linux66-rt"}));
+
+    // The counterparts of linux61's packages, not of linux610's or linux61-rt's;
+    // linux61-rtl8821cu is a module and not the realtime kernel
+    CHECK((planner.installPackages({"linux66"}, "linux61")
+            == Packages{"linux66", "linux66-nvidia", "linux66-rtl8821cu"}));
+    CHECK((planner.installPackages({"linux66-rt"}, "linux61-rt")
+            == Packages{"linux66-rt", "linux66-rt-nvidia"}));
+    CHECK((planner.installPackages({"linux66", "linux66"}, "linux61")
+            == Packages{"linux66", "linux66-nvidia", "linux66-rtl8821cu"}));
+    CHECK((planner.installPackages({"linux66"}, "linux610") == Packages{"linux66", "linux66-nvidia"}));
+
+    CHECK((planner.removePackages({"linux61"}, "linux610") == Packages{"linux61", "linux61-nvidia",
+            "linux61-rtl8821cu", "linux61-virtualbox-host-modules"}));
+    CHECK((planner.removePackages({"linux61-rt"}, "linux61") == Packages{"linux61-rt",
+            "linux61-rt-nvidia"}));
+    CHECK((planner.removePackages({"linux610"}, "linux61") == Packages{"linux610", "linux610-nvidia"}));
+
+    CHECK(throws([&planner]() { planner.installPackages({"linux61"}, "linux61"); }));
+    CHECK(throws([&planner]() { planner.installPackages({"linux612"}, "linux61"); }));
+    CHECK(throws([&planner]() { planner.installPackages({"linux-lts"}, "linux61"); }));
+    CHECK(throws([&planner]() { planner.removePackages({"linux66"}, "linux61"); }));
+    CHECK(throws([&planner]() { planner.removePackages({"linux61"}, "linux61"); }));
+
+    Test::removeDirectory(root);
+    return Test::result();
+}
@@ -0,0 +1,86 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ModaliasIndex.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    typedef std::vector<std::string> IDs;
+}
+
+int main()
+{
+    const std::string directory{Test::temporaryDirectory()};
+    Test::writeFile(directory + "/modules.alias",
+            "# Aliases extracted from modules themselves.\n"
+            "alias pci:v000010DEd00001C82sv*sd*bc03sc00i* nvidia\n"
+            "alias pci:v000010DEd00001C82sv*sd*bc03sc02i* nvidia\n"
+            "alias pci:v000010DEd00001C81sv*sd*bc03sc00i* nvidia\n"
+            "alias pci:v000010DEd*sv*sd*bc03sc00i* nvidia\n"
+            // Only the 4 leading zeros of the 8 digit ids are dropped
+            "alias pci:v00001002d0000000Fsv*sd*bc*sc*i* amdgpu\n"
+            "alias pci:v00001AF4d00001000sv*sd*bc*sc*i* virtio_pci\n"
+            "alias pci:v00008086d*sv*sd*bc0Csc03i30* xhci_pci\n"
+            "alias usb:v05ACp*d*dc*dsc*dp*ic*isc*ip*in* apple_mfi_fastcharge\n"
+            "alias pci:broken nvidia\n");
+    Test::writeFile(directory + "/modules.builtin.alias",
+            "alias pci:v00008086d00000A2Asv*sd*bc*sc*i* intel_builtin\n");
+
+    const ModaliasIndex index{directory + "/modules.alias"};
+
+    // In the order modules.alias lists them, without duplicates
+    const ModaliasIndex::IDs nvidia{index.ids("nvidia")};
+    CHECK("nvidia" == nvidia.module);
+    CHECK((nvidia.classIDs == IDs{"0300", "0302"}));
+    CHECK((nvidia.vendorIDs == IDs{"10DE"}));
+    CHECK((nvidia.deviceIDs == IDs{"1C82", "1C81", "*"}));
+
+    const ModaliasIndex::IDs amdgpu{index.ids("amdgpu")};
+    CHECK((amdgpu.classIDs == IDs{"**"}));
+    CHECK((amdgpu.vendorIDs == IDs{"1002"}));
+    CHECK((amdgpu.deviceIDs == IDs{"000F"}));
+    CHECK((index.ids("virtio_pci").vendorIDs == IDs{"1AF4"}));
+
+    // '-' and '_' are the same in module names, files stand for their module
+    CHECK((index.ids("xhci-pci").classIDs == IDs{"0C03"}));
+    CHECK((index.ids("/lib/modules/6.1.0/kernel/nvidia.ko.zst").deviceIDs == nvidia.deviceIDs));
+    CHECK(index.contains("intel_builtin"));
+    CHECK((index.ids("intel-builtin").deviceIDs == IDs{"0A2A"}));
+
+    // Modules without pci aliases print empty lists, like mhwd-modalias did
+    CHECK(!index.contains("apple_mfi_fastcharge"));
+    CHECK(index.ids("apple_mfi_fastcharge").classIDs.empty());
+    std::ostringstream out;
+    ModaliasIndex::write(out, {index.ids("missing")});
+    CHECK("CLASSIDS=\"\"\nVENDORIDS=\"\"\nDEVICEIDS=\"\"\n" == out.str());
+
+    Test::removeDirectory(directory);
+    return Test::result();
+}
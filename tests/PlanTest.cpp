@@ -0,0 +1,136 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Plan.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    Plan::Step step(MHWD::TRANSACTIONTYPE type, MHWD::BUS bus, const std::string& name,
+            bool dependency, const std::vector<std::string>& removedPackages,
+            const std::vector<std::string>& installedPackages)
+    {
+        std::shared_ptr<Config> config{new Config("/var/lib/mhwd/db/pci/" + name + "/MHWDCONFIG",
+                bus)};
+        config->name_ = name;
+        config->version_ = "2023.01.01";
+        return {type, config, dependency, removedPackages, installedPackages};
+    }
+
+    bool sameSteps(const Plan& written, const Plan& read)
+    {
+        if (written.steps.size() != read.steps.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < written.steps.size(); ++i)
+        {
+            const Plan::Step& a = written.steps[i];
+            const Plan::Step& b = read.steps[i];
+            if ((a.type != b.type) || (a.config->type_ != b.config->type_)
+                    || (a.config->name_ != b.config->name_)
+                    || (a.config->version_ != b.config->version_)
+                    || (a.config->configPath_ != b.config->configPath_)
+                    || (a.dependency != b.dependency) || (a.removedPackages != b.removedPackages)
+                    || (a.installedPackages != b.installedPackages))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool readFails(const std::string& text)
+    {
+        std::istringstream in(text);
+        try
+        {
+            Plan::read(in);
+        }
+        catch(const std::runtime_error&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+int main()
+{
+    Plan host;
+    host.sync = true;
+    host.steps.push_back(step(MHWD::TRANSACTIONTYPE::REMOVE, MHWD::BUS::PCI, "video-nvidia", false,
+            {"nvidia-utils", "lib32-nvidia-utils"}, {}));
+    host.steps.push_back(step(MHWD::TRANSACTIONTYPE::INSTALL, MHWD::BUS::PCI, "video-linux", true,
+            {}, {"mesa"}));
+    host.steps.push_back(step(MHWD::TRANSACTIONTYPE::INSTALL, MHWD::BUS::USB, "usb-dock", false,
+            {}, {}));
+
+    // Without --root there is one plan and no root line
+    std::stringstream hostText;
+    host.write(hostText);
+    CHECK(std::string::npos == hostText.str().find("root|"));
+    std::vector<Plan> plans{Plan::read(hostText)};
+    CHECK(1 == plans.size());
+    CHECK(plans.front().root.empty());
+    CHECK(plans.front().sync);
+    CHECK(sameSteps(host, plans.front()));
+
+    // With --root each root line starts the plan of that root, in the order written
+    Plan first{host};
+    first.root = "/mnt/first";
+    Plan second;
+    second.root = "/mnt/second";
+    second.steps.push_back(step(MHWD::TRANSACTIONTYPE::INSTALL, MHWD::BUS::PCI, "video-linux",
+            false, {}, {"mesa", "xf86-video-amdgpu"}));
+    Plan empty;
+    empty.root = "/mnt/empty";
+
+    std::stringstream rootsText;
+    first.write(rootsText);
+    second.write(rootsText);
+    empty.write(rootsText);
+    plans = Plan::read(rootsText);
+    CHECK(3 == plans.size());
+    CHECK(("/mnt/first" == plans[0].root) && plans[0].sync && sameSteps(first, plans[0]));
+    CHECK(("/mnt/second" == plans[1].root) && !plans[1].sync && sameSteps(second, plans[1]));
+    CHECK(("/mnt/empty" == plans[2].root) && plans[2].steps.empty());
+
+    std::istringstream nothing("# only a comment\n\n");
+    CHECK(Plan::read(nothing).empty());
+
+    CHECK(readFails("sync|no\ninstall|PCI|video-linux\n"));
+    CHECK(readFails("update|PCI|video-linux|1|config|/path||\n"));
+    CHECK(readFails("install|ISA|video-linux|1|config|/path||\n"));
+
+    return Test::result();
+}
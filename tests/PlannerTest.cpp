@@ -0,0 +1,106 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Config.hpp"
+#include "Data.hpp"
+#include "Plan.hpp"
+#include "Planner.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    void writeConfig(const std::string& dbDir, const std::string& name, const std::string& extra)
+    {
+        Test::writeFile(dbDir + "/pci/" + name + "/MHWDCONFIG",
+                "NAME=\"" + name + "\"\nVERSION=\"1\"\nFREEDRIVER=\"true\"\n"
+                "CLASSIDS=\"0300\"\nVENDORIDS=\"*\"\nDEVICEIDS=\"*\"\n" + extra);
+    }
+
+    MHWD::STATUS plan(const Data& data, const std::vector<std::string>& names, Planner& planner)
+    {
+        std::vector<std::shared_ptr<Config>> configs;
+        for (const auto& name : names)
+        {
+            configs.push_back(data.getDatabaseConfig(name, MHWD::BUS::PCI));
+        }
+        Plan plan;
+        return planner.plan(configs, MHWD::TRANSACTIONTYPE::INSTALL, plan);
+    }
+}
+
+int main()
+{
+    const std::string root{Test::temporaryDirectory()};
+    const std::string dbDir{root + "/db"};
+
+    // a and b conflict directly, c pulls in d which conflicts with a
+    writeConfig(dbDir, "a", "MHWDCONFLICTS=\"b\"\n");
+    writeConfig(dbDir, "b", "");
+    writeConfig(dbDir, "c", "MHWDDEPENDS=\"d\"\n");
+    writeConfig(dbDir, "d", "MHWDCONFLICTS=\"a\"\n");
+    writeConfig(dbDir, "e", "");
+    Test::makeDirectories(root + "/local/pci");
+    Test::makeDirectories(root + "/local/usb");
+    Test::makeDirectories(dbDir + "/usb");
+
+    Data::Environment environment;
+    environment.PMRootPath = root;
+    environment.PCIConfigDir = dbDir + "/pci";
+    environment.USBConfigDir = dbDir + "/usb";
+    environment.PCIDatabaseDir = root + "/local/pci";
+    environment.USBDatabaseDir = root + "/local/usb";
+    const Data data{environment, {}, {}};
+
+    {
+        // Declared by the config planned first
+        Planner planner{data, false};
+        CHECK(MHWD::STATUS::ERROR_CONFLICTS == plan(data, {"a", "b"}, planner));
+        CHECK((nullptr != planner.failedConfig_) && ("b" == planner.failedConfig_->name_));
+        CHECK((1 == planner.blockingConfigs_.size()) && ("a" == planner.blockingConfigs_.front()->name_));
+    }
+    {
+        // Declared by the config planned second
+        Planner planner{data, false};
+        CHECK(MHWD::STATUS::ERROR_CONFLICTS == plan(data, {"b", "a"}, planner));
+        CHECK((1 == planner.blockingConfigs_.size()) && ("b" == planner.blockingConfigs_.front()->name_));
+    }
+    {
+        // Declared by a dependency
+        Planner planner{data, false};
+        CHECK(MHWD::STATUS::ERROR_CONFLICTS == plan(data, {"a", "c"}, planner));
+        CHECK((1 == planner.blockingConfigs_.size()) && ("a" == planner.blockingConfigs_.front()->name_));
+    }
+    {
+        Planner planner{data, false};
+        CHECK(MHWD::STATUS::SUCCESS == plan(data, {"b", "c", "e"}, planner));
+    }
+
+    Test::removeDirectory(root);
+    return Test::result();
+}
@@ -0,0 +1,95 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "TestUtils.hpp"
+#include "vita/string.hpp"
+
+namespace
+{
+    std::vector<std::string> split(const std::string& value, char delimiter)
+    {
+        // The fields point into the string, it has to outlive them
+        const Vita::string string{value};
+        std::vector<Vita::stringview> fields;
+        const std::size_t count = string.split(delimiter, fields);
+        CHECK(count == fields.size());
+
+        std::vector<std::string> strings;
+        for (const auto& field : fields)
+        {
+            strings.push_back(field.str());
+        }
+        return strings;
+    }
+}
+
+int main()
+{
+    // Every delimiter separates two fields, even empty ones
+    CHECK((split("0300|10de|1c82|1:0:0", '|')
+            == std::vector<std::string>{"0300", "10de", "1c82", "1:0:0"}));
+    CHECK((split("a||b", '|') == std::vector<std::string>{"a", "", "b"}));
+    CHECK((split("a|b|", '|') == std::vector<std::string>{"a", "b", ""}));
+    CHECK((split("|", '|') == std::vector<std::string>{"", ""}));
+    CHECK((split("", '|') == std::vector<std::string>{""}));
+    CHECK((split("no delimiter", '|') == std::vector<std::string>{"no delimiter"}));
+
+    unsigned long value = 42;
+    CHECK(Vita::stringview("1234").toUnsigned(value) && (1234 == value));
+    CHECK(Vita::stringview("10dE", 4).toUnsigned(value, 16) && (0x10de == value));
+    CHECK(Vita::stringview("0").toUnsigned(value) && (0 == value));
+
+    // Failures leave the value alone
+    value = 42;
+    CHECK(!Vita::stringview("").toUnsigned(value));
+    CHECK(!Vita::stringview("12a").toUnsigned(value));
+    CHECK(!Vita::stringview("1c").toUnsigned(value, 10));
+    CHECK(!Vita::stringview("-1").toUnsigned(value));
+    CHECK(!Vita::stringview(" 1").toUnsigned(value));
+    CHECK(!Vita::stringview("0x10").toUnsigned(value, 16));
+    CHECK(42 == value);
+
+    // The largest value parses, one more overflows
+    const std::string max{std::to_string(ULONG_MAX)};
+    CHECK(Vita::stringview(max).toUnsigned(value) && (ULONG_MAX == value));
+    std::string overflow{max};
+    ++overflow.back();
+    value = 42;
+    CHECK(!Vita::stringview(overflow).toUnsigned(value));
+    CHECK(!Vita::stringview(max + "0").toUnsigned(value));
+    CHECK(!Vita::stringview(std::string(sizeof(unsigned long) * 2 + 1, 'f')).toUnsigned(value, 16));
+    CHECK(Vita::stringview(std::string(sizeof(unsigned long) * 2, 'f')).toUnsigned(value, 16)
+            && (ULONG_MAX == value));
+
+    // A view stops at its size, not at the end of the string behind it
+    CHECK(Vita::stringview("12345", 2).toUnsigned(value) && (12 == value));
+    CHECK(Vita::stringview(" 12 ").trim().toUnsigned(value) && (12 == value));
+
+    return Test::result();
+}
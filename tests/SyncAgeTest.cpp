@@ -0,0 +1,79 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <ctime>
+#include <string>
+
+#include "const.h"
+#include "PackagePlanner.hpp"
+#include "TestUtils.hpp"
+
+namespace
+{
+    constexpr long HOUR = 3600;
+    constexpr long YEAR = 365 * 24 * HOUR;
+
+    void setModificationTime(const std::string& path, long age)
+    {
+        const std::time_t time = std::time(nullptr) - age;
+        struct utimbuf times{time, time};
+        utime(path.c_str(), &times);
+    }
+}
+
+int main()
+{
+    const std::string root{Test::temporaryDirectory()};
+    const std::string database{root + "/var/lib/pacman/sync/core.db"};
+    const std::string stamp{root + MHWD_PM_SYNC_STAMP};
+
+    CHECK(-1 == PackagePlanner::syncDatabaseAge(root));
+
+    // Just written by a sync, but the mirror last changed the repo a year ago
+    Test::writeFile(database, "core");
+    setModificationTime(database, YEAR);
+    CHECK(PackagePlanner::syncDatabaseAge(root) < HOUR);
+
+    // mhwd's own sync stamp counts, whatever the databases say
+    Test::removeDirectory(root + "/var/lib/pacman");
+    Test::makeDirectories(root + "/var/lib/mhwd/local");
+    CHECK(PackagePlanner::recordSync(root));
+    CHECK(PackagePlanner::syncDatabaseAge(root) < HOUR);
+
+    setModificationTime(stamp, 2 * HOUR);
+    const long age = PackagePlanner::syncDatabaseAge(root);
+    CHECK((age >= 2 * HOUR) && (age < 3 * HOUR));
+
+    // A newer sync wins over an older one
+    Test::writeFile(database, "core");
+    setModificationTime(database, YEAR);
+    CHECK(PackagePlanner::syncDatabaseAge(root) < HOUR);
+
+    Test::removeDirectory(root);
+    return Test::result();
+}
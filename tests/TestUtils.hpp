@@ -0,0 +1,104 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TESTUTILS_HPP_
+#define TESTUTILS_HPP_
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * Just enough for the tests: CHECK reports a failed condition and marks
+ * the test failed, TemporaryDirectory gives each test a scratch tree.
+ */
+namespace Test
+{
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition)
+        {
+            std::cerr << file << ":" << line << ": CHECK(" << expression << ") failed\n";
+            ++failures();
+        }
+    }
+
+    inline std::string temporaryDirectory()
+    {
+        char path[] = "/tmp/mhwd-test-XXXXXX";
+        return (nullptr != mkdtemp(path)) ? path : "";
+    }
+
+    // Creates the missing directories of path, like mkdir -p
+    inline void makeDirectories(const std::string& path)
+    {
+        for (std::size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+        {
+            mkdir(path.substr(0, pos).c_str(), S_IRWXU);
+            if (std::string::npos == pos)
+            {
+                break;
+            }
+        }
+    }
+
+    inline void writeFile(const std::string& path, const std::string& content)
+    {
+        makeDirectories(path.substr(0, path.rfind('/')));
+        std::ofstream file(path, std::ios::trunc);
+        file << content;
+    }
+
+    inline void removeDirectory(const std::string& path)
+    {
+        nftw(path.c_str(), [](const char* entry, const struct stat*, int, struct FTW*) {
+                    return remove(entry);
+                }, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    inline int result()
+    {
+        if (0 != failures())
+        {
+            std::cerr << failures() << " check(s) failed\n";
+        }
+        return (0 == failures()) ? 0 : 1;
+    }
+}
+
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif /* TESTUTILS_HPP_ */
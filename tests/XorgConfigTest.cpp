@@ -0,0 +1,244 @@
+/*
+ *  This file is part of the mhwd - Manjaro Hardware Detection project
+ *
+ *  mhwd - Manjaro Hardware Detection
+ *  Roland Singer <roland@manjaro.org>
+ *  Łukasz Matysiak <december0123@gmail.com>
+ *  Filipe Marques <eagle.software3@gmail.com>
+ *
+ *  Copyright (C) 2012 - 2016 Manjaro (http://manjaro.org)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Device.hpp"
+#include "TestUtils.hpp"
+#include "XorgConfig.hpp"
+
+namespace
+{
+    // The helpers of scripts/include/0300 and scripts/mhwd that appended the
+    // sections line by line before mhwd wrote them
+    const char* const OLD_HELPERS = R"SH(
+IDENTIFIERCOUNT=0
+
+MHWD_DEVICE_BUS_ID()
+{
+    local CCLASSID="$1"
+    local CVENDORID="$2"
+    local ONLYFIRST="$3"
+
+    for device in ${MHWDDEVICES[@]}; do
+        while read CLASSID VENDORID DEVICEID BUSID; do
+            if [ "$CVENDORID" == "*" ]; then
+                VENDORID="*"
+            fi
+
+            if [ "$CCLASSID" == "$CLASSID" ] && [ "$CVENDORID" == "$VENDORID" ]; then
+                echo "$BUSID"
+
+                if [ "$ONLYFIRST" == "true" ] || [ "$ONLYFIRST" == "yes" ]; then
+                    return
+                fi
+            fi
+        done <<< "$(echo "$device" | sed 's/|/ /g')"
+    done
+}
+
+MHWD_ADD_DEVICE_SECTION_FOR_EACH_BUSID()
+{
+    local XORGDRIVER="$1"
+    local XORGFILE="$2"
+    local VENDORID="$3"
+    local PCIBUSIDS=""
+
+    if [ "$VENDORID" != "" ]; then
+        PCIBUSIDS="$(MHWD_DEVICE_BUS_ID "0300" "$VENDORID" "false")"
+    fi
+
+    if [ "$PCIBUSIDS" == "" ]; then
+        MHWD_ADD_DEVICE_SECTION "$XORGDRIVER" "$XORGFILE" "$4"
+        return
+    fi
+
+    while read BUSID; do
+        MHWD_ADD_DEVICE_SECTION "$XORGDRIVER" "$XORGFILE" "BusID       \"PCI:$BUSID\"|$4"
+    done <<< "$(echo "$PCIBUSIDS")"
+}
+
+MHWD_ADD_DEVICE_SECTION()
+{
+    local XORGDRIVER="$1"
+    local XORGFILE="$2"
+
+    echo 'Section "Device"' >> "$XORGFILE"
+    echo "    Identifier  \"Device${IDENTIFIERCOUNT}\"" >> "$XORGFILE"
+    echo "    Driver      \"$XORGDRIVER\"" >> "$XORGFILE"
+
+    IFS='|'
+    for i in $3; do
+        echo "    $i" >> "$XORGFILE"
+    done
+    unset IFS
+
+    echo 'EndSection' >> "$XORGFILE"
+    echo ' ' >> "$XORGFILE"
+
+    IDENTIFIERCOUNT=$[IDENTIFIERCOUNT + 1]
+}
+)SH";
+
+    const char* const HEADING = "##\n## Generated by mhwd - Manjaro Hardware Detection\n##\n \n \n";
+
+    // As the scripts get them: CLASSID|VENDORID|DEVICEID|BUSID
+    const std::vector<std::string> DEVICES{"0300|10de|1c82|1:0:0", "0302|10de|1c83|2:0:0",
+            "0300|8086|3e9b|0:2:0"};
+
+    struct Call
+    {
+        std::string driver;
+        // Empty for MHWD_ADD_DEVICE_SECTION
+        std::string vendorID;
+        std::string lines;
+    };
+
+    const std::vector<Call> CALLS{
+        {"nvidia", "10de", "Option      \"NoLogo\" \"1\"|"},
+        {"modesetting", "*", ""},
+        // No display controller of this vendor, one section without BusID
+        {"radeon", "1002", "Option      \"a\" \"1\"||Option      \"b\" \"2\""},
+        {"intel", "", "Option      \"DRI\" \"3\"|Option      \"TearFree\" \"true\""},
+        {"vesa", "", ""},
+    };
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::ostringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    std::string quoted(const std::string& value)
+    {
+        std::string quotedValue{"'"};
+        for (char c : value)
+        {
+            quotedValue += ('\'' == c) ? std::string("'\\''") : std::string(1, c);
+        }
+        return quotedValue + "'";
+    }
+
+    // Runs the calls through the old helpers, returns the IDENTIFIERCOUNT they left
+    unsigned int writeWithOldHelpers(const std::string& directory, const std::string& xorgFile)
+    {
+        std::string script{"MHWDDEVICES=("};
+        for (const auto& device : DEVICES)
+        {
+            script += " " + quoted(device);
+        }
+        script += " )\n" + std::string(OLD_HELPERS);
+        for (const auto& call : CALLS)
+        {
+            if (call.vendorID.empty())
+            {
+                script += "MHWD_ADD_DEVICE_SECTION " + quoted(call.driver) + " " + quoted(xorgFile)
+                        + " " + quoted(call.lines) + "\n";
+            }
+            else
+            {
+                script += "MHWD_ADD_DEVICE_SECTION_FOR_EACH_BUSID " + quoted(call.driver) + " "
+                        + quoted(xorgFile) + " " + quoted(call.vendorID) + " "
+                        + quoted(call.lines) + "\n";
+            }
+        }
+        script += "echo \"$IDENTIFIERCOUNT\" > " + quoted(directory + "/count") + "\n";
+
+        Test::writeFile(directory + "/old.sh", script);
+        CHECK(0 == std::system(("bash " + quoted(directory + "/old.sh")).c_str()));
+        return std::stoul(readFile(directory + "/count"));
+    }
+
+    // The same calls as mhwd --xorgdevices makes them, one XorgConfig each
+    unsigned int writeWithXorgConfig(const std::string& xorgFile)
+    {
+        std::vector<std::shared_ptr<Device>> devices;
+        for (const auto& deviceArgument : DEVICES)
+        {
+            std::istringstream fields(deviceArgument);
+            std::string field[4];
+            for (auto& value : field)
+            {
+                std::getline(fields, value, '|');
+            }
+
+            std::shared_ptr<Device> device{new Device()};
+            device->classID_ = field[0];
+            device->vendorID_ = field[1];
+            device->deviceID_ = field[2];
+            device->sysfsBusID_ = field[3];
+            devices.push_back(device);
+        }
+
+        unsigned int identifier = 0;
+        for (const auto& call : CALLS)
+        {
+            XorgConfig xorgConfig(xorgFile);
+            identifier += xorgConfig.addDeviceSections(call.driver, devices, call.vendorID,
+                    call.lines, "", identifier);
+            CHECK(xorgConfig.write());
+        }
+        return identifier;
+    }
+}
+
+int main()
+{
+    const std::string directory{Test::temporaryDirectory()};
+
+    Test::writeFile(directory + "/old.conf", HEADING);
+    Test::writeFile(directory + "/new.conf", HEADING);
+    const unsigned int oldCount = writeWithOldHelpers(directory, directory + "/old.conf");
+    const unsigned int newCount = writeWithXorgConfig(directory + "/new.conf");
+    CHECK(oldCount == newCount);
+    CHECK(readFile(directory + "/old.conf") == readFile(directory + "/new.conf"));
+
+    // A symlinked config stays a symlink, the file it points to keeps its mode
+    const std::string target{directory + "/90-mhwd.conf"};
+    const std::string link{directory + "/xorg.conf"};
+    Test::writeFile(target, HEADING);
+    chmod(target.c_str(), 0640);
+    CHECK(0 == symlink(target.c_str(), link.c_str()));
+    writeWithXorgConfig(link);
+
+    struct stat linkStatus;
+    struct stat targetStatus;
+    CHECK((0 == lstat(link.c_str(), &linkStatus)) && S_ISLNK(linkStatus.st_mode));
+    CHECK((0 == stat(target.c_str(), &targetStatus)) && (0640 == (targetStatus.st_mode & 07777)));
+    CHECK(readFile(target) == readFile(directory + "/new.conf"));
+
+    Test::removeDirectory(directory);
+    return Test::result();
+}